@@ -0,0 +1,277 @@
+/** @file fleet.c
+ * @brief Host harness that runs a fleet of vending machines on a thread pool.
+ *
+ * Every machine is one struct vending (vending.h) with its own coins and
+ * output buffer. The machines are split in chunks of FLEET_CHUNK and the
+ * worker threads take the next free chunk, so the load is balanced. Each
+ * worker makes synthetic traffic (coins, browsing, purchases and returns)
+ * with its own random generator and gives it to its machines in turns.
+ * \n The transactions go to a ledger:
+ * - shared: one ledger for the whole fleet behind a mutex (like a central
+ *   journal). The harness counts how many times the mutex was busy.
+ * - local: one ledger per worker, added together at the end.
+ *
+ * At the end it checks that no money was created or lost
+ * (coins in = sales + refunds + credit left, and the coins in the machines
+ * = float + coins in - refunds) and prints the throughput.
+ *
+ * Build and run (default: 10000 machines, 4 threads, 200 events each, shared):
+ * @verbatim
+   gcc -std=gnu11 -O2 -pthread -I../src fleet.c ../src/vending.c ../src/coins.c ../src/catalog.c -o fleet
+   ./fleet [machines] [threads] [events] [shared|local]
+   @endverbatim
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+/* Includes */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "vending.h"
+
+#define FLEET_CHUNK 64     /* Machines taken by a worker at a time */
+#define FLEET_LINE_SIZE 80 /* Same as DISPLAY_COLS on the board */
+
+struct ledger {
+    uint64_t coins_in; /* Cents inserted */
+    uint64_t sales;
+    uint64_t revenue;  /* Cents of the products sold */
+    uint64_t refunded; /* Cents returned */
+    uint64_t records;
+};
+
+/* One cache line each, so the counters of two workers never share a line */
+struct worker {
+    _Alignas(64) pthread_t thread;
+    uint32_t rng;
+    uint64_t events;
+    struct ledger local;
+};
+
+struct machine {
+    struct vending v;
+    struct worker *w;  /* Worker running the machine now */
+    int lines;
+    char line[FLEET_LINE_SIZE];
+};
+
+static struct machine *fleet;
+static int num_machines;
+static int events_per_machine;
+static bool shared_mode = true;
+
+static atomic_int next_chunk = 0;
+
+static struct ledger shared;
+static pthread_mutex_t shared_lock = PTHREAD_MUTEX_INITIALIZER;
+static atomic_ullong lock_busy = 0;
+
+static void fleet_clear(void *user)
+{
+    struct machine *m = user;
+
+    m->lines = 0;
+}
+
+static void fleet_print(void *user, const char *fmt, va_list args)
+{
+    struct machine *m = user;
+
+    /* Formats the line as the display would, then drops it */
+    vsnprintf(m->line, sizeof(m->line), fmt, args);
+    m->lines++;
+}
+
+static void add_record(struct ledger *l, enum journal_type type, uint16_t item, uint16_t amount)
+{
+    (void)item; /* The ledger only counts money */
+
+    switch (type) {
+    case JOURNAL_COIN:
+        l->coins_in += amount;
+        break;
+    case JOURNAL_SALE:
+        l->sales++;
+        l->revenue += amount;
+        break;
+    case JOURNAL_REFUND:
+        l->refunded += amount;
+        break;
+    default:
+        break;
+    }
+    l->records++;
+}
+
+static void fleet_record(void *user, enum journal_type type, uint16_t item, uint16_t amount)
+{
+    struct machine *m = user;
+
+    if (!shared_mode) {
+        add_record(&m->w->local, type, item, amount);
+        return;
+    }
+
+    if (pthread_mutex_trylock(&shared_lock) != 0) {
+        atomic_fetch_add_explicit(&lock_busy, 1, memory_order_relaxed);
+        pthread_mutex_lock(&shared_lock);
+    }
+    add_record(&shared, type, item, amount);
+    pthread_mutex_unlock(&shared_lock);
+}
+
+static const struct vending_ops fleet_ops = {
+    .clear = fleet_clear,
+    .print = fleet_print,
+    .record = fleet_record,
+};
+
+/* xorshift32 */
+static uint32_t next_random(struct worker *w)
+{
+    w->rng ^= w->rng << 13;
+    w->rng ^= w->rng >> 17;
+    w->rng ^= w->rng << 5;
+    return w->rng;
+}
+
+/* Synthetic client: 40% coins, 20% browsing, 25% purchases, 15% returns */
+static uint8_t next_event(struct worker *w)
+{
+    uint32_t r = next_random(w) % 100;
+
+    if (r < 40) {
+        return EVT_BUT1 + r % 4;
+    }
+    if (r < 60) {
+        return (r & 1) ? EVT_BUT5 : EVT_BUT7;
+    }
+    if (r < 85) {
+        return EVT_BUT8;
+    }
+    return EVT_BUT6;
+}
+
+static void *worker_code(void *arg)
+{
+    struct worker *w = arg;
+    int chunk, first, last, i, e;
+
+    while ((chunk = atomic_fetch_add(&next_chunk, 1)) * FLEET_CHUNK < num_machines) {
+        first = chunk * FLEET_CHUNK;
+        last = (first + FLEET_CHUNK < num_machines) ? first + FLEET_CHUNK : num_machines;
+
+        for (i = first; i < last; i++) {
+            fleet[i].w = w;
+        }
+        /* One event per machine in turns, like clients arriving at different machines */
+        for (e = 0; e < events_per_machine; e++) {
+            for (i = first; i < last; i++) {
+                vending_event(&fleet[i].v, next_event(w));
+                w->events++;
+            }
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    const uint16_t no_coins[COIN_TYPES] = { 0 };
+    struct ledger total = { 0 };
+    struct worker *workers;
+    struct timespec t0, t1;
+    uint64_t events = 0, credit_left = 0, coins_left = 0, float_in = 0;
+    bool want_shared = true;
+    int threads, i, c;
+    double secs;
+
+    num_machines = (argc > 1) ? atoi(argv[1]) : 10000;
+    threads = (argc > 2) ? atoi(argv[2]) : 4;
+    events_per_machine = (argc > 3) ? atoi(argv[3]) : 200;
+    if (argc > 4) {
+        want_shared = (strcmp(argv[4], "local") != 0);
+    }
+
+    if (num_machines < 1 || threads < 1 || events_per_machine < 0) {
+        printf("Usage: %s [machines] [threads] [events] [shared|local]\n", argv[0]);
+        return 1;
+    }
+
+    fleet = calloc(num_machines, sizeof(*fleet));
+    workers = aligned_alloc(_Alignof(struct worker), threads * sizeof(*workers));
+    if (fleet == NULL || workers == NULL) {
+        printf("Out of memory\n");
+        return 1;
+    }
+    memset(workers, 0, threads * sizeof(*workers));
+
+    /* The float is loaded before the clock starts; its records are not counted */
+    shared_mode = false;
+    for (i = 0; i < num_machines; i++) {
+        fleet[i].w = &workers[0];
+        vending_init(&fleet[i].v, &fleet_ops, &fleet[i], 0, no_coins);
+    }
+    memset(&workers[0].local, 0, sizeof(workers[0].local));
+    shared_mode = want_shared;
+
+    for (i = 0; i < threads; i++) {
+        workers[i].rng = 0x9e3779b9u * (uint32_t)(i + 1);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (i = 0; i < threads; i++) {
+        pthread_create(&workers[i].thread, NULL, worker_code, &workers[i]);
+    }
+    for (i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    total = shared;
+    for (i = 0; i < threads; i++) {
+        events += workers[i].events;
+        total.coins_in += workers[i].local.coins_in;
+        total.sales += workers[i].local.sales;
+        total.revenue += workers[i].local.revenue;
+        total.refunded += workers[i].local.refunded;
+        total.records += workers[i].local.records;
+    }
+    for (i = 0; i < num_machines; i++) {
+        credit_left += fleet[i].v.credit;
+        for (c = 0; c < COIN_TYPES; c++) {
+            coins_left += (uint64_t)coins_count(&fleet[i].v.coins, c) * coin_value[c];
+        }
+    }
+    for (c = 0; c < COIN_TYPES; c++) {
+        float_in += (uint64_t)coins_float[c] * coin_value[c] * num_machines;
+    }
+
+    printf("Machines: %d  Threads: %d  Events: %llu  Ledger: %s\n", num_machines, threads,
+           (unsigned long long)events, shared_mode ? "shared" : "local");
+    printf("Sales: %llu  Revenue: %llu  Refunded: %llu  Credit left: %llu\n",
+           (unsigned long long)total.sales, (unsigned long long)total.revenue,
+           (unsigned long long)total.refunded, (unsigned long long)credit_left);
+    printf("Time: %.3f s  ->  %.0f events/s\n", secs, (secs > 0) ? events / secs : 0.0);
+    if (shared_mode) {
+        printf("Ledger mutex busy: %llu of %llu records (%.2f%%)\n",
+               (unsigned long long)atomic_load(&lock_busy), (unsigned long long)total.records,
+               total.records ? 100.0 * atomic_load(&lock_busy) / total.records : 0.0);
+    }
+
+    /* Money in = money out + credit, and the coins in the machines match it */
+    if (total.coins_in != total.revenue + total.refunded + credit_left ||
+        coins_left != float_in + total.coins_in - total.refunded) {
+        printf("Money check: WRONG\n");
+        return 1;
+    }
+    printf("Money check: OK\n");
+    return 0;
+}
@@ -0,0 +1,19 @@
+/** @file catalog.c
+ * @brief Products sold by the vending machine.
+ *
+ * To add a product just add a line to the table; the menu, the browsing
+ * and the selection use the table directly.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include "catalog.h"
+
+const struct product catalog[] = {
+    { "Beer",           150 },
+    { "Tuna Sandwich",  100 },
+    { "Coffee",          50 },
+};
+
+const uint16_t catalog_size = sizeof(catalog) / sizeof(catalog[0]);
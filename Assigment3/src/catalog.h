@@ -0,0 +1,62 @@
+/** @file catalog.h
+ * @brief Product catalog of the vending machine.
+ *
+ * The products are kept in one const table (stored in flash) and are
+ * selected by their index, so getting a product or its price does not
+ * depend on the number of products.
+ * \n The menu shows the catalog in pages of CATALOG_PAGE_SIZE products.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _catalog_h
+#define _catalog_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CATALOG_PAGE_SIZE 5 /* Products shown in each page of the menu */
+
+/**
+ * @brief One product of the vending machine.
+ */
+struct product {
+    const char *name; /**< Name shown in the menu */
+    uint16_t price;   /**< Price in cents */
+};
+
+/** @brief Table with all the products, indexed by the selection. */
+extern const struct product catalog[];
+
+/** @brief Number of products in the catalog. */
+extern const uint16_t catalog_size;
+
+/**
+ * @brief Returns the product at the index, or NULL if there is none.
+ */
+static inline const struct product *catalog_get(int index)
+{
+    if (index < 0 || index >= catalog_size) {
+        return NULL;
+    }
+    return &catalog[index];
+}
+
+/**
+ * @brief Page of the menu where the product at the index is shown.
+ */
+static inline int catalog_page(int index)
+{
+    return index / CATALOG_PAGE_SIZE;
+}
+
+/**
+ * @brief Number of pages of the menu.
+ */
+static inline int catalog_pages(void)
+{
+    return (catalog_size + CATALOG_PAGE_SIZE - 1) / CATALOG_PAGE_SIZE;
+}
+
+#endif
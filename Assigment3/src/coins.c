@@ -0,0 +1,151 @@
+/** @file coins.c
+ * @brief Coin inventory and change engine of the vending machine.
+ *
+ * The DP works in units of COIN_UNIT and takes the coin types one by one,
+ * from the largest to the smallest. take[s][a] is the smallest number of
+ * coins of step s needed to reach the amount a together with the coins of
+ * the previous steps (NO_WAY if it cannot be reached). Keeping the smallest
+ * number lets the next amount reuse it, so each step is one pass over the
+ * amounts, independent of the number of coins in the machine.
+ * \n The table is a local of coins_change(), so two machines never share
+ * it and the coin box only holds the counts.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "coins.h"
+
+#define MAX_UNITS (COINS_MAX_CHANGE / COIN_UNIT)
+#define NO_WAY 0xff
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+_Static_assert(MAX_UNITS < NO_WAY, "COINS_MAX_CHANGE too large for the DP table");
+
+const uint16_t coin_value[COIN_TYPES] = { 10, 20, 50, 100 };
+
+const uint16_t coins_float[COIN_TYPES] = { 10, 10, 4, 0 };
+
+/* Change for 0..90 cents with unlimited coins (10, 20, 50, 100) */
+static const uint8_t small_change[10][COIN_TYPES] = {
+    { 0, 0, 0, 0 }, /*  0 */
+    { 1, 0, 0, 0 }, /* 10 */
+    { 0, 1, 0, 0 }, /* 20 */
+    { 1, 1, 0, 0 }, /* 30 */
+    { 0, 2, 0, 0 }, /* 40 */
+    { 0, 0, 1, 0 }, /* 50 */
+    { 1, 0, 1, 0 }, /* 60 */
+    { 0, 1, 1, 0 }, /* 70 */
+    { 1, 1, 1, 0 }, /* 80 */
+    { 0, 2, 1, 0 }, /* 90 */
+};
+
+int coin_index(int value)
+{
+    int i;
+
+    for (i = 0; i < COIN_TYPES; i++) {
+        if (coin_value[i] == value) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void coins_set(struct coin_box *box, const uint16_t count[COIN_TYPES])
+{
+    memcpy(box->count, count, sizeof(box->count));
+}
+
+uint16_t coins_count(const struct coin_box *box, int index)
+{
+    return box->count[index];
+}
+
+void coins_add(struct coin_box *box, int index, uint16_t n)
+{
+    box->count[index] += n;
+}
+
+void coins_remove(struct coin_box *box, const uint16_t out[COIN_TYPES])
+{
+    int i;
+
+    for (i = 0; i < COIN_TYPES; i++) {
+        box->count[i] -= MIN(out[i], box->count[i]);
+    }
+}
+
+/* Fast path: the table plus 100 cent coins, if the machine has them */
+static bool change_from_table(const struct coin_box *box, int units, uint16_t out[COIN_TYPES])
+{
+    const uint8_t *small = small_change[units % 10];
+    int i;
+
+    for (i = 0; i < COIN_TYPES - 1; i++) {
+        out[i] = small[i];
+    }
+    out[COIN_TYPES - 1] = units / 10;
+
+    for (i = 0; i < COIN_TYPES; i++) {
+        if (out[i] > box->count[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Bounded DP, returns the units that can be given (the largest reachable <= units) */
+static int change_from_dp(const struct coin_box *box, int units, uint16_t out[COIN_TYPES])
+{
+    uint8_t take[COIN_TYPES][COINS_DP_SIZE];
+    const uint8_t *prev;
+    int s, a, best, idx, d, limit;
+
+    for (s = 0; s < COIN_TYPES; s++) {
+        idx = COIN_TYPES - 1 - s;
+        d = coin_value[idx] / COIN_UNIT;
+        limit = MIN(box->count[idx], MAX_UNITS);
+        prev = (s > 0) ? take[s - 1] : NULL;
+
+        for (a = 0; a <= units; a++) {
+            if ((prev == NULL) ? (a == 0) : (prev[a] != NO_WAY)) {
+                take[s][a] = 0;
+            } else if (a >= d && take[s][a - d] != NO_WAY && take[s][a - d] < limit) {
+                take[s][a] = take[s][a - d] + 1;
+            } else {
+                take[s][a] = NO_WAY;
+            }
+        }
+    }
+
+    best = units;
+    while (take[COIN_TYPES - 1][best] == NO_WAY) {
+        best--; /* Stops at 0, which is always reachable */
+    }
+
+    a = best;
+    for (s = COIN_TYPES - 1; s >= 0; s--) {
+        idx = COIN_TYPES - 1 - s;
+        out[idx] = take[s][a];
+        a -= take[s][a] * (coin_value[idx] / COIN_UNIT);
+    }
+    return best;
+}
+
+int coins_change(const struct coin_box *box, int amount, uint16_t out[COIN_TYPES])
+{
+    int units = (amount > 0) ? amount / COIN_UNIT : 0;
+
+    if (change_from_table(box, units, out)) {
+        return units * COIN_UNIT;
+    }
+
+    return change_from_dp(box, MIN(units, MAX_UNITS), out) * COIN_UNIT;
+}
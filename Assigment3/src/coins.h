@@ -0,0 +1,85 @@
+/** @file coins.h
+ * @brief Coin inventory and change engine of the vending machine.
+ *
+ * The machine accepts coins of 10, 20, 50 and 100 cents and keeps count of
+ * how many of each it holds. When the credit is returned, coins_change()
+ * decides which coins to give:
+ * - The usual case uses a precomputed table: the euros are given in
+ *   100 cent coins and the table gives the coins for the cents below 1 euro.
+ * - If the machine does not have those coins, a DP bounded to
+ *   COINS_MAX_CHANGE finds another combination with the coins it has.
+ *
+ * Both run in a fixed number of steps. When the exact amount cannot be
+ * given, the result is the largest amount below it that can, so the machine
+ * never promises change it does not have.
+ * \n All the state is in struct coin_box, one per machine, so the functions
+ * can be used by many machines at the same time.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _coins_h
+#define _coins_h
+
+#include <stdint.h>
+
+#define COIN_TYPES 4           /* 10, 20, 50 and 100 cents */
+#define COIN_UNIT 10           /* Smallest coin, every amount is a multiple of it */
+#define COINS_MAX_CHANGE 2000  /* Largest amount handled by the DP, in cents */
+
+#define COINS_DP_SIZE (COINS_MAX_CHANGE / COIN_UNIT + 1)
+
+/**
+ * @brief Coins held by one machine.
+ */
+struct coin_box {
+    uint16_t count[COIN_TYPES]; /**< Coins of each type */
+};
+
+/** @brief Value of each coin type in cents, from the smallest to the largest. */
+extern const uint16_t coin_value[COIN_TYPES];
+
+/** @brief Coins loaded in a machine whose inventory is empty. */
+extern const uint16_t coins_float[COIN_TYPES];
+
+/**
+ * @brief Index of the coin with this value.
+ * @return the index in coin_value[], or -1 if it is not an accepted coin
+ */
+int coin_index(int value);
+
+/**
+ * @brief Replaces the whole inventory (at boot, from the journal).
+ */
+void coins_set(struct coin_box *box, const uint16_t count[COIN_TYPES]);
+
+/**
+ * @brief Number of coins of one type in the machine.
+ */
+uint16_t coins_count(const struct coin_box *box, int index);
+
+/**
+ * @brief Adds coins to the inventory (coin inserted or float loaded).
+ */
+void coins_add(struct coin_box *box, int index, uint16_t n);
+
+/**
+ * @brief Removes the coins given as change from the inventory.
+ * @param out coins of each type, as returned by coins_change()
+ */
+void coins_remove(struct coin_box *box, const uint16_t out[COIN_TYPES]);
+
+/**
+ * @brief Chooses the coins to return for an amount, using only the coins
+ * in the inventory. Does not change the inventory.
+ * \n The DP table (COIN_TYPES x COINS_DP_SIZE bytes) is a local of the call,
+ * on the stack of the caller's thread.
+ * @param box coins of the machine
+ * @param amount cents to return
+ * @param out number of coins of each type to give
+ * @return cents that can be returned (amount, or less if there is no exact change)
+ */
+int coins_change(const struct coin_box *box, int amount, uint16_t out[COIN_TYPES]);
+
+#endif
@@ -0,0 +1,141 @@
+/** @file display.c
+ * @brief Frame buffered terminal renderer for the vending machine UI.
+ *
+ * Keeps two frames: the one being built and the one on the terminal.
+ * display_flush() compares them line by line and puts the differences in
+ * the tx buffer, which is sent with uart_tx() (async API, EasyDMA on the
+ * nRF52840). If the async API is not available the buffer is printed with
+ * printk instead.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <devicetree.h>
+#include <drivers/uart.h>
+#include <sys/printk.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "display.h"
+
+#define ESC_CLEAR_SCREEN "\x1b[2J"
+#define ESC_MOVE_MAX 8    /* "\x1b[rr;1H" */
+#define ESC_ERASE_EOL "\x1b[K"
+#define TX_BUFFER_SIZE (DISPLAY_ROWS * (DISPLAY_COLS + ESC_MOVE_MAX + sizeof(ESC_ERASE_EOL)) + \
+                        sizeof(ESC_CLEAR_SCREEN) + ESC_MOVE_MAX)
+#define TX_TIMEOUT_MS 500
+
+static char frame[DISPLAY_ROWS][DISPLAY_COLS];  /* Frame being built */
+static char shown[DISPLAY_ROWS][DISPLAY_COLS];  /* Frame on the terminal */
+static int next_row = 0;
+static bool redraw_all = true;
+
+static char tx_buffer[TX_BUFFER_SIZE];
+static const struct device *uart_dev = NULL;
+static bool uart_async = false;
+
+K_SEM_DEFINE(tx_done, 1, 1);
+
+static void uart_cb(const struct device *dev, struct uart_event *evt, void *user_data)
+{
+    if (evt->type == UART_TX_DONE || evt->type == UART_TX_ABORTED) {
+        k_sem_give(&tx_done);
+    }
+}
+
+int display_init(void)
+{
+    uart_dev = DEVICE_DT_GET(DT_CHOSEN(zephyr_console));
+    if (!device_is_ready(uart_dev)) {
+        printk("Display: console UART not ready\n\r");
+        uart_dev = NULL;
+        return -ENODEV;
+    }
+
+    uart_async = (uart_callback_set(uart_dev, uart_cb, NULL) == 0);
+
+    memset(shown, 0, sizeof(shown));
+    display_clear();
+    redraw_all = true;
+
+    return 0;
+}
+
+void display_clear(void)
+{
+    memset(frame, 0, sizeof(frame));
+    next_row = 0;
+}
+
+void display_vprintf(const char *fmt, va_list args)
+{
+    if (next_row >= DISPLAY_ROWS) {
+        return;
+    }
+
+    vsnprintk(frame[next_row], DISPLAY_COLS, fmt, args);
+    next_row++;
+}
+
+void display_printf(const char *fmt, ...)
+{
+    va_list args;
+
+    va_start(args, fmt);
+    display_vprintf(fmt, args);
+    va_end(args);
+}
+
+void display_flush(void)
+{
+    size_t len = 0;
+    int row;
+
+    /* Waits until the previous frame left the tx buffer */
+    if (uart_async && k_sem_take(&tx_done, K_MSEC(TX_TIMEOUT_MS)) != 0) {
+        uart_tx_abort(uart_dev);
+        k_sem_reset(&tx_done);
+    }
+
+    if (redraw_all) {
+        memcpy(tx_buffer, ESC_CLEAR_SCREEN, sizeof(ESC_CLEAR_SCREEN) - 1);
+        len = sizeof(ESC_CLEAR_SCREEN) - 1;
+    }
+
+    for (row = 0; row < DISPLAY_ROWS; row++) {
+        /* After clearing the screen only the lines with text need to be sent */
+        if (redraw_all ? (frame[row][0] == '\0') : (strcmp(frame[row], shown[row]) == 0)) {
+            strcpy(shown[row], frame[row]);
+            continue;
+        }
+        len += snprintk(&tx_buffer[len], TX_BUFFER_SIZE - len, "\x1b[%d;1H%s" ESC_ERASE_EOL,
+                        row + 1, frame[row]);
+        strcpy(shown[row], frame[row]);
+    }
+
+    /* Leaves the cursor after the last line, so other messages do not overwrite the UI */
+    if (len > 0) {
+        len += snprintk(&tx_buffer[len], TX_BUFFER_SIZE - len, "\x1b[%d;1H", DISPLAY_ROWS + 1);
+    }
+    redraw_all = false;
+
+    if (len == 0) {
+        if (uart_async) {
+            k_sem_give(&tx_done);
+        }
+        return;
+    }
+
+    if (uart_async) {
+        if (uart_tx(uart_dev, (const uint8_t *)tx_buffer, len, SYS_FOREVER_MS) != 0) {
+            k_sem_give(&tx_done);
+            redraw_all = true; /* The terminal state is unknown, redraw next time */
+        }
+    } else {
+        tx_buffer[MIN(len, TX_BUFFER_SIZE - 1)] = '\0';
+        printk("%s", tx_buffer);
+    }
+}
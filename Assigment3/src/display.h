@@ -0,0 +1,56 @@
+/** @file display.h
+ * @brief Frame buffered terminal renderer for the vending machine UI.
+ *
+ * The screen is built line by line in a RAM frame buffer. When the frame is
+ * flushed, only the lines that are different from the ones on the terminal
+ * are sent, each one after a cursor positioning escape, and the whole frame
+ * goes to the UART in a single transfer.
+ *
+ * Usage:
+ * @code
+ * display_clear();
+ * display_printf("Products (%d/%d) :", page, pages);
+ * display_printf("Dinheiro Atual : %d Centimos", credit);
+ * display_flush();
+ * @endcode
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _display_h
+#define _display_h
+
+#include <stdarg.h>
+
+#define DISPLAY_ROWS 16 /* Lines of the frame */
+#define DISPLAY_COLS 80 /* Characters per line, including the terminator */
+
+/**
+ * @brief Binds to the console UART and clears the terminal.
+ * @return 0 on success, or a negative error code if the UART is not ready
+ */
+int display_init(void);
+
+/**
+ * @brief Starts a new frame. The lines that are not written stay empty.
+ */
+void display_clear(void);
+
+/**
+ * @brief Writes the next line of the frame. Lines after DISPLAY_ROWS are ignored
+ * and text longer than the line is cut.
+ */
+void display_printf(const char *fmt, ...);
+
+/**
+ * @brief Same as display_printf(), with the arguments in a va_list.
+ */
+void display_vprintf(const char *fmt, va_list args);
+
+/**
+ * @brief Sends the lines that changed since the last flush in one UART transfer.
+ */
+void display_flush(void);
+
+#endif
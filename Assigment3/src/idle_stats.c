@@ -0,0 +1,67 @@
+/** @file idle_stats.c
+ * @brief Idle time and wakeup counters of the vending machine.
+ *
+ * sys_trace_idle_user() runs in the idle thread, with the interrupts
+ * locked, right before the CPU goes to sleep. The interrupt that wakes it
+ * up calls sys_trace_isr_enter_user(), which closes the idle period. So
+ * the idle time is the sum of those periods and every close is a wakeup.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#include "idle_stats.h"
+
+static uint32_t idle_start = 0;      /* Cycle when the CPU went to sleep */
+static bool in_idle = false;
+static uint64_t idle_cycles = 0;     /* Total time asleep */
+static uint32_t wakeups = 0;
+static uint32_t events = 0;
+
+void sys_trace_idle_user(void)
+{
+    idle_start = k_cycle_get_32();
+    in_idle = true;
+}
+
+void sys_trace_isr_enter_user(int nested_interrupts)
+{
+    if (in_idle) {
+        idle_cycles += k_cycle_get_32() - idle_start;
+        in_idle = false;
+        wakeups++;
+    }
+}
+
+void idle_stats_event(void)
+{
+    events++;
+}
+
+void idle_stats_print(void)
+{
+    uint64_t idle_ms, total_ms;
+    uint32_t wake, evts;
+    unsigned int key;
+
+    key = irq_lock();
+    idle_ms = k_cyc_to_ms_floor64(idle_cycles);
+    wake = wakeups;
+    evts = events;
+    irq_unlock(key);
+
+    total_ms = k_uptime_get();
+    if (total_ms == 0 || idle_ms > total_ms) {
+        return;
+    }
+
+    printk("\n\r--- Power: up %u ms, idle %u ms (%u.%02u%%), active %u ms ---\n\r",
+           (uint32_t)total_ms, (uint32_t)idle_ms,
+           (uint32_t)(idle_ms * 100 / total_ms), (uint32_t)(idle_ms * 10000 / total_ms % 100),
+           (uint32_t)(total_ms - idle_ms));
+    printk("Wakeups: %u  Events: %u  Wakeups/event: %u.%02u\n\r", wake, evts,
+           evts ? wake / evts : 0, evts ? (wake * 100 / evts) % 100 : 0);
+}
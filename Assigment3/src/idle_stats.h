@@ -0,0 +1,32 @@
+/** @file idle_stats.h
+ * @brief Idle time and wakeup counters of the vending machine.
+ *
+ * With the tickless kernel the CPU only wakes up for interrupts that have
+ * work to do (a button edge, the debounce timer, the UART), so between
+ * clients it should stay in idle. These counters give the evidence:
+ * - time spent in the idle thread (CPU sleeping) and the rest (active),
+ * - wakeups, each interrupt that takes the CPU out of idle,
+ * - events handled by the State Machine, and so wakeups per event.
+ *
+ * They are kept by the kernel tracing hooks (CONFIG_TRACING_USER) and
+ * printed on the console by idle_stats_print(), from the shell command
+ * "stats power".
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _idle_stats_h
+#define _idle_stats_h
+
+/**
+ * @brief Counts one event handled by the State Machine.
+ */
+void idle_stats_event(void);
+
+/**
+ * @brief Prints the idle and active time, the wakeups and the wakeups per event.
+ */
+void idle_stats_print(void);
+
+#endif
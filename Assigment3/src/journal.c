@@ -0,0 +1,279 @@
+/** @file journal.c
+ * @brief Flash journal of the vending machine transactions.
+ *
+ * NVS layout:
+ * - id JOURNAL_ID_CHECKPOINT: the totals and the sequence number of the
+ *   first batch that is not included in them.
+ * - ids JOURNAL_ID_BATCH + (seq % JOURNAL_TAIL_SLOTS): the batches. Each
+ *   one stores its own sequence number, so a slot left from an older round
+ *   is recognized and ends the replay.
+ *
+ * There are twice as many slots as batches between checkpoints, so a batch
+ * that is still needed is never overwritten, even if one checkpoint write
+ * fails.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <devicetree.h>
+#include <drivers/flash.h>
+#include <storage/flash_map.h>
+#include <fs/nvs.h>
+#include <sys/printk.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "journal.h"
+
+#define JOURNAL_SECTORS 4 /* Flash pages of the storage partition used by NVS */
+#define JOURNAL_TAIL_SLOTS (2 * JOURNAL_CHECKPOINT_EVERY)
+
+#define JOURNAL_ID_CHECKPOINT 1
+#define JOURNAL_ID_BATCH 2
+
+struct journal_batch {
+    uint32_t seq;
+    uint8_t count;
+    struct journal_record rec[JOURNAL_BATCH_SIZE];
+};
+
+struct journal_checkpoint {
+    uint32_t next_seq;
+    struct journal_totals totals;
+};
+
+#define BATCH_HEADER_SIZE offsetof(struct journal_batch, rec)
+
+static struct nvs_fs fs;
+static bool journal_ready = false;
+
+static struct journal_batch pending;        /* Records not yet in flash */
+static struct journal_totals live;          /* Totals with the pending records */
+static struct journal_totals stored;        /* Totals of the records in flash */
+static uint32_t next_seq = 0;               /* Sequence number of the next batch */
+static uint32_t checkpoint_seq = 0;         /* next_seq saved in the last checkpoint */
+
+K_MUTEX_DEFINE(journal_lock);
+
+static void flush_work_handler(struct k_work *work);
+K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_handler);
+
+static uint16_t batch_id(uint32_t seq)
+{
+    return JOURNAL_ID_BATCH + (seq % JOURNAL_TAIL_SLOTS);
+}
+
+static void apply(struct journal_totals *t, const struct journal_record *r)
+{
+    int coin = coin_index(r->amount);
+
+    switch (r->type) {
+    case JOURNAL_COIN:
+        t->credit += r->amount;
+        if (coin >= 0) {
+            t->coins[coin]++;
+        }
+        break;
+    case JOURNAL_SALE:
+        t->credit -= r->amount;
+        t->sales++;
+        t->revenue += r->amount;
+        break;
+    case JOURNAL_REFUND:
+        t->credit -= r->amount;
+        break;
+    case JOURNAL_CHANGE:
+        if (coin >= 0) {
+            t->coins[coin] -= MIN(r->item, t->coins[coin]);
+        }
+        break;
+    case JOURNAL_FILL:
+        if (coin >= 0) {
+            t->coins[coin] += r->item;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* Called with journal_lock held */
+static int write_checkpoint(void)
+{
+    struct journal_checkpoint cp = { .next_seq = next_seq, .totals = stored };
+    ssize_t rc = nvs_write(&fs, JOURNAL_ID_CHECKPOINT, &cp, sizeof(cp));
+
+    if (rc < 0) {
+        printk("Error %d: failed to write the journal checkpoint\n\r", (int)rc);
+        return (int)rc;
+    }
+    checkpoint_seq = next_seq;
+    return 0;
+}
+
+/* Called with journal_lock held */
+static int write_pending(void)
+{
+    ssize_t rc;
+
+    if (pending.count == 0) {
+        return 0;
+    }
+
+    /* The slot still holds a batch after the checkpoint: save the totals first */
+    if (next_seq - checkpoint_seq >= JOURNAL_TAIL_SLOTS && write_checkpoint() != 0) {
+        return -EIO;
+    }
+
+    pending.seq = next_seq;
+    rc = nvs_write(&fs, batch_id(next_seq), &pending,
+                   BATCH_HEADER_SIZE + pending.count * sizeof(struct journal_record));
+    if (rc < 0) {
+        printk("Error %d: failed to write the journal\n\r", (int)rc);
+        return (int)rc;
+    }
+
+    next_seq++;
+    pending.count = 0;
+    stored = live;
+
+    if (next_seq - checkpoint_seq >= JOURNAL_CHECKPOINT_EVERY) {
+        write_checkpoint();
+    }
+    return 0;
+}
+
+static void flush_work_handler(struct k_work *work)
+{
+    journal_flush();
+}
+
+int journal_flush(void)
+{
+    int ret;
+
+    if (!journal_ready) {
+        return -ENODEV;
+    }
+
+    k_mutex_lock(&journal_lock, K_FOREVER);
+    ret = write_pending();
+    k_mutex_unlock(&journal_lock);
+    return ret;
+}
+
+void journal_add(enum journal_type type, uint16_t item, uint16_t amount)
+{
+    struct journal_record r = { .type = type, .item = item, .amount = amount };
+
+    if (!journal_ready) {
+        return;
+    }
+
+    k_mutex_lock(&journal_lock, K_FOREVER);
+
+    /* Batch still full (the work did not run yet): write it here */
+    if (pending.count == JOURNAL_BATCH_SIZE && write_pending() != 0) {
+        printk("Error: journal full, transaction not saved\n\r");
+        k_mutex_unlock(&journal_lock);
+        return;
+    }
+
+    pending.rec[pending.count++] = r;
+    apply(&live, &r);
+
+    if (pending.count == JOURNAL_BATCH_SIZE) {
+        k_work_reschedule(&flush_work, K_NO_WAIT);
+    } else if (pending.count == 1) {
+        k_work_schedule(&flush_work, K_MSEC(JOURNAL_FLUSH_MS));
+    }
+
+    k_mutex_unlock(&journal_lock);
+}
+
+struct journal_totals journal_totals(void)
+{
+    struct journal_totals t;
+
+    k_mutex_lock(&journal_lock, K_FOREVER);
+    t = live;
+    k_mutex_unlock(&journal_lock);
+    return t;
+}
+
+int journal_init(struct journal_totals *totals)
+{
+    const struct device *flash_dev = device_get_binding(DT_LABEL(DT_CHOSEN(zephyr_flash_controller)));
+    struct flash_pages_info info;
+    struct journal_checkpoint cp;
+    struct journal_batch batch;
+    uint32_t replayed = 0;
+    ssize_t rc;
+    int i;
+
+    memset(totals, 0, sizeof(*totals));
+
+    if (flash_dev == NULL) {
+        printk("Error: flash device not found, journal disabled\n\r");
+        return -ENODEV;
+    }
+
+    fs.offset = FLASH_AREA_OFFSET(storage);
+    rc = flash_get_page_info_by_offs(flash_dev, fs.offset, &info);
+    if (rc != 0) {
+        printk("Error %d: unable to get the flash page info\n\r", (int)rc);
+        return (int)rc;
+    }
+    fs.sector_size = info.size;
+    fs.sector_count = JOURNAL_SECTORS;
+
+    rc = nvs_init(&fs, flash_dev->name);
+    if (rc != 0) {
+        printk("Error %d: failed to mount the journal\n\r", (int)rc);
+        return (int)rc;
+    }
+
+    /* Checkpoint (absent on a new board: start from zero) */
+    rc = nvs_read(&fs, JOURNAL_ID_CHECKPOINT, &cp, sizeof(cp));
+    if (rc == sizeof(cp)) {
+        stored = cp.totals;
+        next_seq = cp.next_seq;
+    } else {
+        memset(&stored, 0, sizeof(stored));
+        next_seq = 0;
+    }
+    checkpoint_seq = next_seq;
+
+    /* Tail: the batches written after the checkpoint, in order. The size must match exactly,
+     * so a batch written with another record layout ends the replay */
+    while (replayed < JOURNAL_TAIL_SLOTS) {
+        rc = nvs_read(&fs, batch_id(next_seq), &batch, sizeof(batch));
+        if (rc < (ssize_t)BATCH_HEADER_SIZE || batch.seq != next_seq ||
+            batch.count > JOURNAL_BATCH_SIZE ||
+            rc != (ssize_t)(BATCH_HEADER_SIZE + batch.count * sizeof(struct journal_record))) {
+            break;
+        }
+        for (i = 0; i < batch.count; i++) {
+            apply(&stored, &batch.rec[i]);
+        }
+        next_seq++;
+        replayed++;
+    }
+
+    live = stored;
+    pending.count = 0;
+    journal_ready = true;
+
+    /* Long tail (a checkpoint was lost): save one now to keep the next boot short */
+    if (replayed >= JOURNAL_CHECKPOINT_EVERY) {
+        write_checkpoint();
+    }
+
+    printk("Journal: %u batches replayed after the checkpoint\n\r", (unsigned int)replayed);
+
+    *totals = stored;
+    return 0;
+}
@@ -0,0 +1,88 @@
+/** @file journal.h
+ * @brief Flash journal of the vending machine transactions.
+ *
+ * Every change of the credit (coin inserted, product sold, credit returned)
+ * and of the coins in the machine is appended to a journal kept in the
+ * storage partition with NVS, so the credit, the sales and the coin
+ * inventory survive a reset.
+ * \n The records are kept in RAM and written together, as one NVS entry,
+ * when JOURNAL_BATCH_SIZE records are pending or JOURNAL_FLUSH_MS after the
+ * first one. NVS spreads the entries over its sectors (wear leveling).
+ * \n Every JOURNAL_CHECKPOINT_EVERY batches the totals are saved as a
+ * checkpoint. At boot the totals are rebuilt from the checkpoint plus the
+ * batches written after it, so the whole log is never replayed.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _journal_h
+#define _journal_h
+
+#include <stdint.h>
+
+#include "coins.h"
+
+#define JOURNAL_BATCH_SIZE 8        /* Records written in one flash entry */
+#define JOURNAL_FLUSH_MS 2000       /* Longest time a record waits in RAM */
+#define JOURNAL_CHECKPOINT_EVERY 16 /* Batches between checkpoints */
+
+/**
+ * @brief Kind of transaction.
+ */
+enum journal_type {
+    JOURNAL_COIN,   /**< Coin inserted, amount added to the credit */
+    JOURNAL_SALE,   /**< Product sold, amount taken from the credit */
+    JOURNAL_REFUND, /**< Credit returned, amount taken from the credit */
+    JOURNAL_CHANGE, /**< Coins given as change: item coins of value amount */
+    JOURNAL_FILL    /**< Coins loaded in the machine: item coins of value amount */
+};
+
+/**
+ * @brief One transaction, as stored in flash.
+ */
+struct journal_record {
+    uint8_t type;    /**< One of enum journal_type */
+    uint16_t item;   /**< Catalog index of the product (JOURNAL_SALE) or number of coins, as wide as both */
+    uint16_t amount; /**< Cents (value of the coin for JOURNAL_CHANGE and JOURNAL_FILL) */
+};
+
+/**
+ * @brief State rebuilt from the journal.
+ */
+struct journal_totals {
+    int32_t credit;   /**< Credit of the client, in cents */
+    uint32_t sales;   /**< Products sold */
+    uint32_t revenue; /**< Money of the products sold, in cents */
+    uint16_t coins[COIN_TYPES]; /**< Coins of each type in the machine */
+};
+
+/**
+ * @brief Mounts the journal and rebuilds the totals from the last
+ * checkpoint and the batches after it.
+ * @param totals where the recovered totals are stored (zero if the journal is empty)
+ * @return 0 on success, or a negative error code (the journal is then disabled)
+ */
+int journal_init(struct journal_totals *totals);
+
+/**
+ * @brief Appends one transaction. Only copies the record to RAM, the
+ * flash write is done later by the system work queue.
+ * @param type kind of transaction
+ * @param item catalog index of the product sold, or number of coins (0 if not used)
+ * @param amount cents
+ */
+void journal_add(enum journal_type type, uint16_t item, uint16_t amount);
+
+/**
+ * @brief Writes the pending records now (before a planned reset, for example).
+ * @return 0 on success, or a negative error code
+ */
+int journal_flush(void);
+
+/**
+ * @brief Current totals, including the records still in RAM.
+ */
+struct journal_totals journal_totals(void);
+
+#endif
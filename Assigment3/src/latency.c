@@ -0,0 +1,79 @@
+/** @file latency.c
+ * @brief Latency histograms of the button event path.
+ *
+ * The histograms are written by the State Machine thread and printed by the
+ * shell thread, so latency_print() copies each one under a spinlock and
+ * prints the copy.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#include "latency.h"
+
+struct latency_hist latency_debounce = { .name = "edge -> queued" };
+struct latency_hist latency_queue = { .name = "queued -> dequeue" };
+struct latency_hist latency_ui = { .name = "dequeue -> UI done" };
+
+static struct k_spinlock lock;
+
+void latency_add(struct latency_hist *h, timing_t from, timing_t to)
+{
+#ifdef CONFIG_TIMING_FUNCTIONS
+    uint64_t c = timing_cycles_get(&from, &to);
+#else
+    uint64_t c = (uint32_t)(to - from);
+#endif
+    uint32_t cycles = (c > UINT32_MAX) ? UINT32_MAX : c;
+    uint32_t b = (cycles == 0) ? 0 : 32 - __builtin_clz(cycles);
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    h->bucket[b]++;
+    h->count++;
+    if (cycles > h->max) {
+        h->max = cycles;
+    }
+    k_spin_unlock(&lock, key);
+}
+
+static uint32_t to_us(uint64_t cycles)
+{
+#ifdef CONFIG_TIMING_FUNCTIONS
+    return timing_cycles_to_ns(cycles) / 1000;
+#else
+    return k_cyc_to_us_floor64(cycles);
+#endif
+}
+
+static void print_hist(const struct latency_hist *hist)
+{
+    struct latency_hist copy;
+    const struct latency_hist *h = &copy;
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    uint64_t low, high;
+    int b;
+
+    copy = *hist;
+    k_spin_unlock(&lock, key);
+
+    printk("%s: %u events, max %u us\n\r", h->name, h->count, to_us(h->max));
+    for (b = 0; b < LATENCY_BUCKETS; b++) {
+        if (h->bucket[b] == 0) {
+            continue;
+        }
+        low = (b == 0) ? 0 : BIT64(b - 1);
+        high = BIT64(b) - 1;
+        printk("  %10u .. %10u us : %u\n\r", to_us(low), to_us(high), h->bucket[b]);
+    }
+}
+
+void latency_print(void)
+{
+    printk("\n\r--- Latency (log2 buckets) ---\n\r");
+    print_hist(&latency_debounce);
+    print_hist(&latency_queue);
+    print_hist(&latency_ui);
+}
@@ -0,0 +1,63 @@
+/** @file latency.h
+ * @brief Latency histograms of the button event path.
+ *
+ * Each button event carries two stamps: the first GPIO edge of the press
+ * (taken in the GPIO interrupt by the buttons module) and the moment the
+ * debounced press was pushed to the queue. The State Machine takes two more,
+ * when it gets the event from the queue and when the UI update has been
+ * sent, and adds the differences to histograms:
+ * - debounce: GPIO edge -> pushed to the queue,
+ * - queue: pushed -> dequeued by the State Machine,
+ * - ui: dequeued -> display_flush() done.
+ *
+ * The stamps come from buttons_now(), the timing counter (tens of ns per
+ * cycle) and not the 32768 Hz kernel clock, so the short stages do not fall
+ * in one or two buckets. The buckets are powers of 2 of its cycles, so a few
+ * counters cover everything from one cycle to seconds and the tail stays visible.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _latency_h
+#define _latency_h
+
+#include <zephyr.h>
+#include <timing/timing.h>
+
+#define LATENCY_BUCKETS 33 /* Bucket b holds [2^(b-1), 2^b) cycles, bucket 0 holds 0 */
+
+/**
+ * @brief Histogram of one stage.
+ */
+struct latency_hist {
+    const char *name;                 /**< Name shown in the dump */
+    uint32_t bucket[LATENCY_BUCKETS]; /**< Events per bucket */
+    uint32_t count;                   /**< Events in the histogram */
+    uint32_t max;                     /**< Largest latency, in cycles */
+};
+
+/** @brief GPIO edge -> debounced press pushed to the queue. */
+extern struct latency_hist latency_debounce;
+
+/** @brief Pushed to the queue -> dequeued by the State Machine. */
+extern struct latency_hist latency_queue;
+
+/** @brief Dequeued -> UI update sent. */
+extern struct latency_hist latency_ui;
+
+/**
+ * @brief Adds one latency to the histogram.
+ * @param h histogram of the stage
+ * @param from start of the stage, from buttons_now()
+ * @param to end of the stage, from buttons_now()
+ */
+void latency_add(struct latency_hist *h, timing_t from, timing_t to);
+
+/**
+ * @brief Prints the non empty buckets of the histograms on the console, in microseconds.
+ * Called by the shell command "stats latency".
+ */
+void latency_print(void);
+
+#endif
@@ -33,156 +33,139 @@
 #include <device.h>
 #include <devicetree.h>
 #include <drivers/gpio.h>
+#include <shell/shell.h>
 #include <sys/printk.h>
 #include <sys/__assert.h>
+#include <sys/atomic.h>
 #include <string.h>
 #include <timing/timing.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-/* Refer to dts file */
-#define GPIO0_NID DT_NODELABEL(gpio0)
-
-#define BOARDBUT1 0xb /* Pin at which BUT1 is connected. Addressing is direct (i.e., pin number) */
-#define BOARDBUT2 0xc
-#define BOARDBUT3 0x18
-#define BOARDBUT4 0x19
-#define BOARDBUT5 0x3
-#define BOARDBUT6 0x4
-#define BOARDBUT7 0x1c
-#define BOARDBUT8 0x1d
-/* Define States*/
-
-#define S0 0
-#define S1 1
-#define S2 2
-#define S3 3
-#define S4 4
+#include "buttons.h"
+#include "display.h"
+#include "idle_stats.h"
+#include "journal.h"
+#include "latency.h"
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include "replay.h"
+#endif
+#include "trace.h"
+#include "vending.h"
+
+/* Buttons of the machine, refer to the nrf52840dk_nrf52840.overlay file */
+#define BUTTONS_NID DT_PATH(vending_buttons)
 
 #define BLINKPERIOD_MS 500 /* Blink period in ms*/ 
 
-/* Int related declarations */
-static struct gpio_callback but1_cb_data; /* Callback structure */
-static struct gpio_callback but2_cb_data; /* Callback structure */
-static struct gpio_callback but3_cb_data; /* Callback structure */
-static struct gpio_callback but4_cb_data; /* Callback structure */
-static struct gpio_callback but5_cb_data; /* Callback structure */
-static struct gpio_callback but6_cb_data; /* Callback structure */
-static struct gpio_callback but7_cb_data; /* Callback structure */
-static struct gpio_callback but8_cb_data; /* Callback structure */
-
-// Variables that determine which button was selected
-volatile int dcToggleFlag1 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag2 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag3 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag4 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag5 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag6 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag7 = 0; /* Flag to signal a BUT1 press */
-volatile int dcToggleFlag8 = 0; /* Flag to signal a BUT1 press */
-
-
-void but1press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But1 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag1 = 1;
-}
+struct button_event {
+    uint8_t button;  /* Which button was pressed (enum button_id) */
+    timing_t edge;   /* buttons_now() at the first GPIO edge of the press */
+    timing_t queued; /* buttons_now() when it was pushed to the queue */
+};
 
-void but2press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But2 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag2 = 1;
-}
+#define BUTTON_MSGQ_SIZE 16 /* Presses that can wait to be handled */
 
-void but3press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But3 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag3 = 1;
-}
+K_MSGQ_DEFINE(button_msgq, sizeof(struct button_event), BUTTON_MSGQ_SIZE, 4);
 
-void but4press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But4 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag4 = 1;
-}
+/* Presses lost because the queue was full, reported by the State Machine */
+static atomic_t button_drops = ATOMIC_INIT(0);
 
-void but5press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But5 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag5 = 1;
+/* Puts the event in the queue. Never blocks, it is called from the ISRs */
+static void push_button_event(uint8_t button, timing_t edge)
+{
+    struct button_event evt = {
+        .button = button,
+        .edge = edge,
+        .queued = buttons_now(),
+    };
+
+    if (k_msgq_put(&button_msgq, &evt, K_NO_WAIT) != 0) {
+        atomic_inc(&button_drops);
+    }
 }
 
-void but6press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+/* Button -> event table, the pins come from the devicetree */
+static const struct button_map button_table[] = {
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_1), gpios), EVT_BUT1 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_2), gpios), EVT_BUT2 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_3), gpios), EVT_BUT3 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_4), gpios), EVT_BUT4 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_5), gpios), EVT_BUT5 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_6), gpios), EVT_BUT6 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_7), gpios), EVT_BUT7 },
+    { GPIO_DT_SPEC_GET(DT_CHILD(BUTTONS_NID, but_8), gpios), EVT_BUT8 },
+};
+
+void buttonPressed(uint8_t event, enum button_action action, timing_t edge)
 {    
-    /* Inform that button was hit*/
-    printk("But6 pressed at %d\n\r", k_cycle_get_32());
+    /* Coins, return and select only count once per press; holding Up/Down browses the menu */
+    if (action != BUTTON_PRESS &&
+        !(action == BUTTON_REPEAT && (event == EVT_BUT5 || event == EVT_BUT7))) {
+        return;
+    }
+
+    /* Inform that button was hit (printed later by the trace thread)*/
+    trace_isr(event + 1, edge);
     
-    /* Update Flag*/
-    dcToggleFlag6 = 1;
+    /* Send the event to the State Machine*/
+    push_button_event(event, edge);
 }
 
-void but7press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But7 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag7 = 1;
+
+/* Output of the machine: the display and the flash journal */
+static void ui_clear(void *user)
+{
+    display_clear();
 }
 
-void but8press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit*/
-    printk("But8 pressed at %d\n\r", k_cycle_get_32());
-    
-    /* Update Flag*/
-    dcToggleFlag8 = 1;
+static void ui_print(void *user, const char *fmt, va_list args)
+{
+    display_vprintf(fmt, args);
 }
 
+static void ui_record(void *user, enum journal_type type, uint16_t item, uint16_t amount)
+{
+    journal_add(type, item, amount);
+}
 
-const struct device *gpio0_dev;         /* Pointer to GPIO device structure */\
+static const struct vending_ops board_ops = {
+    .clear = ui_clear,
+    .print = ui_print,
+    .record = ui_record,
+};
 
-/* Variables for Assigment */
-int credit = 0;
-int choice = 1;
-int state = 0;
+/* The machine of this board */
+static struct vending machine;
 
 
 /* Main function */
 void main(void) 
 {
     
-    /* Bind to GPIO 0 */
-    gpio0_dev = device_get_binding(DT_LABEL(GPIO0_NID));
-    if (gpio0_dev == NULL) 
+    if (CONFIG_BUTTONS() != 0)
     {
-        printk("Failed to bind to GPIO0\n\r");        
+        printk("Failed to configure the buttons\n\r");        
 	return;
     }
-    else 
+
+    display_init();
+
+    /* Credit left before the last reset (the machine still works without the journal) */
+    struct journal_totals totals;
+    if (journal_init(&totals) == 0)
     {
-        printk("Bind to GPIO0 successfull \n\r");        
+        printk("Recovered credit %d Centimos, %u products sold\n\r", (int)totals.credit, (unsigned int)totals.sales);
     }
+    vending_init(&machine, &board_ops, NULL, totals.credit, totals.coins);
 
-    CONFIG_BUTTONS();
+    showMenu(&machine, 1);
+    display_flush();
 
-    showMenu(1);
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+    replay_start(); /* Presses the emulated buttons from a trace */
+#endif
 
     StateMachine();  /* Initialize State Machine*/                
         
@@ -191,279 +174,63 @@ void main(void)
 
 void StateMachine()
 {
-    while(1)
-    {
-      switch(state)
-      {
-        case S0:  /* Fundamental State*/
-
-          if((dcToggleFlag1 == 1) || (dcToggleFlag2 == 1) || (dcToggleFlag3 == 1) || (dcToggleFlag4 == 1) ) /* If any money is added change state*/
-          {
-            state = S1; /* change of state to "Add Money" State*/
-          }
-
-          if(dcToggleFlag6 == 1)  /* If return button is pressed change state*/
-          {
-            state = S2; /* change of state to "Return Money" State*/
-          }
-
-          if((dcToggleFlag5 == 1) || (dcToggleFlag7 == 1)) /* If Up or Down button is pressed change state*/
-          {
-            state = S3; /* change of state to "Browse Up/Down" State*/
-          }
-
-          if(dcToggleFlag8 == 1) /* If Select button is pressed change state*/
-          {
-            state = S4; /* change of state to "Select Product" State*/
-          }
-          break;
-
-        case S1:
-          if(dcToggleFlag1 == 1) /* Checks the amount of money added */
-          {
-            addMoney(10);  /* Adds 10 cents to credit */
-            dcToggleFlag1 = 0;
-          }
-          if(dcToggleFlag2 == 1) 
-          {
-            addMoney(20); /* Adds 20 cents to credit */
-            dcToggleFlag2 = 0;
-          }
-          if(dcToggleFlag3 == 1) 
-          {
-            addMoney(50); /* Adds 50 cents to credit */
-            dcToggleFlag3 = 0;
-          }
-          if(dcToggleFlag4 == 1) 
-          {
-            addMoney(100); /* Adds 100 cents to credit */
-            dcToggleFlag4 = 0;
-          }
-          state = S0;  /* Return to Fundamental State*/
-          break;
-
-        case S2: 
-          resetMoney();   /* Returns money and puts money to 0*/
-          dcToggleFlag6 = 0;
-          state = S0; /* Return to Fundamental State*/
-        
-        case S3:
-          if(dcToggleFlag5 == 1) /* Checks which button was pressed (Up or Down)*/
-          {
-            UpOrDown(2);
-            dcToggleFlag5 = 0;
-          }
-          if(dcToggleFlag7 == 1)
-          {
-            UpOrDown(1);
-            dcToggleFlag7 = 0;
-          }
-          state = S0; /* Return to Fundamental State*/
-          break;
-
-         case S4:
-          Check();  /* Checks if theres is money available and returns product or returns error*/
-          dcToggleFlag8 = 0; 
-          state = S0; /* Return to Fundamental State*/
-          break;
-
-         default: 
-          state = S0; /* Return to Fundamental State*/
-          break;    
-      }
-    }   
-    return 0;
-}
-
-void addMoney(int cach)
-{
-  credit = credit + cach;
-  showMenu(0);
-  showSpace();
-  printk("Dinheiro adicionado : %d Centimos\n\r", cach);
-  printk("Dinheiro Atual : %d Centimos\n\r", credit); 
-  return 0;
-}
-
-void resetMoney()
-{
-  showMenu(0);
-  showSpace();
-  printk("Dinheiro devolvido : %d Centimos\n\r", credit);
-  credit = 0;
-  printk("Dinheiro Atual : %d Centimos\n\r", credit);
-  return 0; 
-}
+  struct button_event evt;
+  timing_t dequeued;
+  atomic_val_t drops;
 
-void UpOrDown(int flag)
-{
-  if(flag == 1)
-  {
-    choice = choice + 1;
-    if(choice >= 4) choice = 1;
-  } else if (flag == 2)
+  while(1)
   {
-    choice = choice - 1;
-    if(choice <= 0) choice = 3;
-  }
-  showMenu(1);
-  return 0;
-}
+    /* Sleeps until a button is pressed, events are handled in order */
+    k_msgq_get(&button_msgq, &evt, K_FOREVER);
+    dequeued = buttons_now();
 
-void Check()
-{
-  if(choice == 1)
-  {
-    if(credit >= 150)
-    {
-      credit = credit - 150;
-      showMenu();
-      showSpace();
-      printk("Produto Entregue (Beer)\n\r");
-      printk("Dinheiro Descontado: 150 Centimos\n\r");
-      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
-    } else 
-    {
-      showMenu();
-      showSpace();
-      printk("Custo do Produto : 150 Centimos\n\r");
-      printk("Dinheiro que Falta: %d Centimos\n\r",(150-credit));
-      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
-    }
-  } else if (choice == 2)
-  {
-    if(credit >= 100)
+    drops = atomic_set(&button_drops, 0);
+    if (drops != 0)
     {
-      credit = credit - 100;
-      showMenu();
-      showSpace();
-      printk("Produto Entregue (Tuna Sandwich)\n\r");
-      printk("Dinheiro Descontado: 100 Centimos\n\r");
-      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
-    } else 
-    {
-      showMenu();
-      showSpace();
-      printk("Custo do Produto : 100 Centimos\n\r");
-      printk("Dinheiro que Falta: %d Centimos\n\r",(100-credit));
-      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
+      printk("Button queue full, %d presses lost\n\r", (int)drops);
     }
-  } else if (choice == 3)
-  {
-    if(credit >= 50)
-    {
-      credit = credit - 50;
-      showMenu();
-      showSpace();
-      printk("Produto Entregue (Coffee)\n\r");
-      printk("Dinheiro Descontado: 50 Centimos\n\r");
-      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
-    } else 
+
+    idle_stats_event();
+    latency_add(&latency_debounce, evt.edge, evt.queued);
+    latency_add(&latency_queue, evt.queued, dequeued);
+
+    if(!vending_event(&machine, evt.button))
     {
-      showMenu();
-      showSpace();
-      printk("Custo do Produto : 50 Centimos\n\r");
-      printk("Dinheiro que Falta: %d Centimos\n\r",(50-credit));
-      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
+      continue; /* Event not used in this state */
     }
-  }
-  return 0;
-}
 
-void showMenu(int flag)
-{
-  printk("\n\x1b[2J\r");
-  if(choice == 1)
-  {
-    printk("Products : \n\r");
-    printk("   - Beer : 150 Centimos              <---- \n\r");
-    printk("   - Tuna Sandwich : 100 Centimos \n\r");
-    printk("   - Coffee Sandwich : 50 Centimos \n\r");
-  } else if(choice == 2)
-  {
-    printk("Products : \n\r");
-    printk("   - Beer : 150 Centimos \n\r");
-    printk("   - Tuna Sandwich : 100 Centimos     <---- \n\r");
-    printk("   - Coffee Sandwich : 50 Centimos \n\r");
-  } else if(choice == 3)
-  {
-    printk("Products : \n\r");
-    printk("   - Beer : 150 Centimos \n\r");
-    printk("   - Tuna Sandwich : 100 Centimos \n\r");
-    printk("   - Coffee Sandwich : 50 Centimos    <---- \n\r");
-  }
-  if(flag == 1)
-  {
-    showSpace();
-    printk("Dinheiro Atual : %d Centimos\n\r", credit); 
+    display_flush(); /* Sends the lines of the UI that changed */
+    latency_add(&latency_ui, dequeued, buttons_now());
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+    replay_event_done();
+#endif
   }
-  return 0;
 }
 
-void showSpace()
+/* Shell command "stats": the statistics are read from the console, no button is involved */
+static int cmd_stats_power(const struct shell *sh, size_t argc, char **argv)
 {
-  printk("\n\r");
-  printk("----------------------------------------------------\n\r");
-  printk("\n\r");
-  return 0;
+    idle_stats_print();
+    return 0;
 }
 
-/*Configure Buttons*/
-
-void CONFIG_BUTTONS()
+static int cmd_stats_latency(const struct shell *sh, size_t argc, char **argv)
 {
-    int ret = 0;
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT1, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT2, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT3, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT4, GPIO_INPUT | GPIO_PULL_UP);
-
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT5, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT6, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT7, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT8, GPIO_INPUT | GPIO_PULL_UP);
-
-    if (ret < 0) {
-        printk("Error %d: Failed to configure BUT 1 \n\r", ret);
-	return;
-    }
-
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT1, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT2, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT3, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT4, GPIO_INT_EDGE_TO_ACTIVE);
-
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT5, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT6, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT7, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT8, GPIO_INT_EDGE_TO_ACTIVE);
-    if (ret != 0) {
-	printk("Error %d: failed to configure interrupt on BUT1 pin \n\r", ret);
-	return;
-    }
-
-    gpio_init_callback(&but1_cb_data, but1press_cbfunction, BIT(BOARDBUT1));
-    gpio_add_callback(gpio0_dev, &but1_cb_data);
-
-    gpio_init_callback(&but2_cb_data, but2press_cbfunction, BIT(BOARDBUT2));
-    gpio_add_callback(gpio0_dev, &but2_cb_data);
-
-    gpio_init_callback(&but3_cb_data, but3press_cbfunction, BIT(BOARDBUT3));
-    gpio_add_callback(gpio0_dev, &but3_cb_data);
-
-    gpio_init_callback(&but4_cb_data, but4press_cbfunction, BIT(BOARDBUT4));
-    gpio_add_callback(gpio0_dev, &but4_cb_data);
+    latency_print();
+    return 0;
+}
 
-    gpio_init_callback(&but5_cb_data, but5press_cbfunction, BIT(BOARDBUT5));
-    gpio_add_callback(gpio0_dev, &but5_cb_data);
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_stats,
+    SHELL_CMD(power, NULL, "Idle time, wakeups and wakeups per event", cmd_stats_power),
+    SHELL_CMD(latency, NULL, "Latency histograms of the button events", cmd_stats_latency),
+    SHELL_SUBCMD_SET_END
+);
 
-    gpio_init_callback(&but6_cb_data, but6press_cbfunction, BIT(BOARDBUT6));
-    gpio_add_callback(gpio0_dev, &but6_cb_data);
+SHELL_CMD_REGISTER(stats, &sub_stats, "Statistics of the vending machine", NULL);
 
-    gpio_init_callback(&but7_cb_data, but7press_cbfunction, BIT(BOARDBUT7));
-    gpio_add_callback(gpio0_dev, &but7_cb_data);
+/*Configure Buttons*/
 
-    gpio_init_callback(&but8_cb_data, but8press_cbfunction, BIT(BOARDBUT8));
-    gpio_add_callback(gpio0_dev, &but8_cb_data);
+int CONFIG_BUTTONS()
+{
+    return buttons_init(button_table, ARRAY_SIZE(button_table), buttonPressed);
 }
-
@@ -16,13 +16,16 @@
 /**
  * @brief 
  * The main function calls all the other functions and initializes the buttons and the State Machine.
+ * \n The credit left before a reset is recovered from the flash journal (journal.h).
+ * \n The machine is one struct vending (vending.h) whose output goes to the display and the journal.
  * 
  * 
  * @code
  * 
  * CONFIG_BUTTONS();
  *
- * showMenu(1);
+ * vending_init(&machine, &board_ops, NULL, totals.credit, totals.coins);
+ * showMenu(&machine, 1);
  *
  * StateMachine(); 
  * 
@@ -37,6 +40,23 @@ void main(void);
  * This function implements the core of the state machine used in the code.
  * \n The concept consistes on the states and the transitions that comprise them.
  * \n It is also focused on the inner states when a coin it's used.
+ * \n The thread sleeps on the button message queue and wakes up once per button event,
+ * so the presses are handled one at a time and in the order they happened.
+ * \n Each event is given to vending_event(), which looks up the const table indexed by
+ * [state][event] (vending.c); each entry gives the state where the action runs, the action
+ * with its argument and the state to return to. The UI is then sent with display_flush().
+ * \n Presses that did not fit in the queue are only counted by the interrupt; the thread prints
+ * how many were lost when it gets the next event.
+ * \n Between events the thread is blocked, so the CPU stays in the tickless idle; each event is
+ * counted for the wakeups per event statistic.
+ * \n The time from the GPIO edge to the queue, from the queue to the dequeue and from the dequeue
+ * to the end of the UI update go to the latency histograms (latency.h).
+ * 
+ * Example of the entries for the coins:
+ * @code
+ * [EVT_BUT1] = { S1, S0, addMoney, 10 },
+ * [EVT_BUT2] = { S1, S0, addMoney, 20 },
+ * @endcode
  * 
  * @verbatim
   - State 0 (Default State)
@@ -48,171 +68,29 @@ void main(void);
  * 
  */
 void StateMachine();
-/**
- * @brief Adds the value chosen to the credit of the user.
- *
- * @code
- * credit = credit + cach;
- * showMenu(0);
- * showSpace();
- * printk("Dinheiro adicionado : %d Centimos\n\r", cach);
- * printk("Dinheiro Atual : %d Centimos\n\r", credit); 
- * @endcode
- * 
- */
-
-void addMoney(int cach);
-
-/**
- * @brief Returns all the credit from the vending machine.
- * \n Returns the value of the credit returned.
- *
- * @code
- * 
- * showMenu(0);
- * showSpace();
- * printk("Dinheiro devolvido : %d Centimos\n\r", credit);
- * credit = 0;
- * printk("Dinheiro Atual : %d Centimos\n\r", credit); 
- * 
- * @endcode
- * 
- */
-void resetMoney();
 
 /**
- * @brief The purpose of this function is to rotate the selection of the highlighted product.
- * 
- * @code
- * 
- * if(flag == 1)
- * {
- *   choice = choice + 1;
- *   if(choice >= 4) choice = 1;
- * } else if (flag == 2)
- * {
- *   choice = choice - 1;
- *   if(choice <= 0) choice = 3;
- * }
- * showMenu(1);
- * @endcode
+ * @brief Function for the configuration of all the buttons.
+ * \n The pins come from the vending-buttons node of the devicetree overlay and are
+ * registered in the shared buttons module with one callback for the GPIO port.
  * 
+ * @return 0 on success, or a negative error code
  */
-void UpOrDown(int flag);
+int CONFIG_BUTTONS();
 
-/**
- * @brief This function is in charge of the logic to 
- * identify and calculate if the credit is enough to buy the product chosen 
- * and inform the user according to that.  
- * 
- * 
- * Example of the logic for the Beer product:
- * @code
- *  if(choice == 1)
- *  {
- *   if(credit >= 150)
- *   {
- *      credit = credit - 150;
- *      showMenu();
- *      showSpace();
- *      printk("Produto Entregue (Beer)\n\r");
- *      printk("Dinheiro Descontado: 150 Centimos\n\r");
- *      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
- *    } else 
- *    {
- *      showMenu();
- *      showSpace();
- *      printk("Custo do Produto : 150 Centimos\n\r");
- *      printk("Dinheiro que Falta: %d Centimos\n\r",(150-credit));
- *      printk("Dinheiro Atual : %d Centimos\n\r", credit); 
- *    }
- *   } 
- * @endcode
- * 
- * @param the result of the choice made and it's aditional information
- */
-void Check();
 
 /**
- * @brief Main function of the UI for the products. This function is called in all the others.
- * \n It's used so that the user can see and interact with the vending machine.
- * 
+ * @brief Called by the buttons module, in interrupt context, for each debounced action of a button.
+ * \n A press (or a repeat of Up/Down while held) is recorded in the trace and pushed to the State Machine queue;
+ * if the queue is full the press is counted as lost, nothing is printed here.
+ * \n Releases and long presses are ignored, so a coin is only counted once. The power statistics
+ * (idle_stats.h) and the latency histograms (latency.h) are printed by the shell commands "stats power" and
+ * "stats latency", not by a button, so asking for them never sells a product.
  * 
- * This is the product options presented for the user:
- * @verbatim 
-    - Beer : 150 Centimos              <----
-    - Tuna Sandwich : 100 Centimos 
-    - Coffee Sandwich : 50 Centimos
-  @endverbatim
- *	
- */
-void showMenu(int flag);
-
-/**
- * @brief Function only to print a separation space between the products and the actions.	
- */
-void showSpace();
-
-
-/**
- * @brief Function for the configuration of all the buttons.	
- */
-void CONFIG_BUTTONS();
-
-
-//
-//functions for button pressed
-//
-
-
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 1 was pressed.
- */ 
-void but1press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 2 was pressed.
- */ 
-void but2press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 3 was pressed.
- */ 
-void but3press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 4 was pressed.
- */ 
-void but4press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 5 was pressed.
- */ 
-void but5press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 6 was pressed.
- */ 
-void but6press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 7 was pressed.
+ * @param event the button (EVT_BUT1 to EVT_BUT8)
+ * @param action what happened to the button
+ * @param edge buttons_now() at the first GPIO edge of the press, carried to the latency histograms
  */ 
-void but7press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 8 was pressed.
- */ 
-void but8press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-
-
-
-
-
-
-
-
-
-
+void buttonPressed(uint8_t event, enum button_action action, timing_t edge);
 
+#endif
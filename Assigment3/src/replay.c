@@ -0,0 +1,147 @@
+/** @file replay.c
+ * @brief Button trace replay and benchmark for the native_posix build.
+ *
+ * Each step of a trace holds one button for hold_ms and then waits gap_ms.
+ * Both are longer than BUTTONS_DEBOUNCE_MS and shorter than
+ * BUTTONS_LONG_PRESS_MS, so every step is exactly one event of the State
+ * Machine and the presses can be matched with the display updates in order.
+ * \n The waits are in simulated time (with
+ * CONFIG_NATIVE_POSIX_SLOWDOWN_TO_REAL_TIME=n they take no host time), while
+ * the latencies come from the host clock, so they measure only the time
+ * spent running the code.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <devicetree.h>
+#include <drivers/gpio.h>
+#include <drivers/gpio/gpio_emul.h>
+#include <sys/printk.h>
+#include <posix_board_if.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "replay.h"
+
+#define REPLAY_STACK_SIZE 2048
+#define REPLAY_PRIO 5
+#define REPLAY_IN_FLIGHT 16   /* Presses waiting for their display update */
+#define REPLAY_DRAIN_MS 1000  /* Time given to the last events before the report */
+
+struct replay_step {
+    uint8_t button;   /* 0 to 7 (EVT_BUT1 to EVT_BUT8) */
+    uint16_t hold_ms;
+    uint16_t gap_ms;
+};
+
+/* Buttons in devicetree order: but-1 .. but-8 */
+#define BUTTON_SPEC(node) GPIO_DT_SPEC_GET(node, gpios),
+static const struct gpio_dt_spec pins[] = {
+    DT_FOREACH_CHILD(DT_PATH(vending_buttons), BUTTON_SPEC)
+};
+
+/* Recorded session: 1 euro + 10 cents, browse, buy, get the change */
+static const struct replay_step session[] = {
+    { 3, 60, 200 }, { 0, 45, 150 }, { 4, 50, 120 }, { 4, 50, 120 },
+    { 6, 50, 300 }, { 7, 80, 400 }, { 5, 70, 500 },
+};
+
+#define MAX_EVENTS (ARRAY_SIZE(session) + REPLAY_GENERATED_EVENTS)
+
+K_MSGQ_DEFINE(press_times, sizeof(uint64_t), REPLAY_IN_FLIGHT, 8);
+
+static uint32_t latency_us[MAX_EVENTS];
+static uint32_t done_events = 0;
+
+static uint64_t host_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+void replay_event_done(void)
+{
+    uint64_t pressed;
+
+    if (k_msgq_get(&press_times, &pressed, K_NO_WAIT) != 0) {
+        return; /* Not a replayed press */
+    }
+    if (done_events < MAX_EVENTS) {
+        latency_us[done_events++] = (uint32_t)(host_now_us() - pressed);
+    }
+}
+
+static void play(const struct replay_step *step)
+{
+    uint64_t now = host_now_us();
+
+    if (k_msgq_put(&press_times, &now, K_NO_WAIT) != 0) {
+        return; /* The State Machine is far behind: the step counts as lost */
+    }
+    gpio_emul_input_set(pins[step->button].port, pins[step->button].pin, 1);
+    k_msleep(step->hold_ms);
+    gpio_emul_input_set(pins[step->button].port, pins[step->button].pin, 0);
+    k_msleep(step->gap_ms);
+}
+
+static int compare_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+
+    return (x > y) - (x < y);
+}
+
+static uint32_t percentile(uint32_t p)
+{
+    return latency_us[(done_events - 1) * p / 100];
+}
+
+static void replay_thread_code(void *argA, void *argB, void *argC)
+{
+    struct replay_step step;
+    uint64_t start, elapsed;
+    uint32_t played = 0;
+    size_t i;
+
+    srand(REPLAY_SEED);
+    start = host_now_us();
+
+    for (i = 0; i < ARRAY_SIZE(session); i++, played++) {
+        play(&session[i]);
+    }
+    for (i = 0; i < REPLAY_GENERATED_EVENTS; i++, played++) {
+        step.button = rand() % ARRAY_SIZE(pins);
+        step.hold_ms = 30 + rand() % 40;
+        step.gap_ms = 40 + rand() % 80;
+        play(&step);
+    }
+
+    k_msleep(REPLAY_DRAIN_MS);
+    elapsed = host_now_us() - start;
+
+    printk("\n\r--- Replay: %u presses, %u processed, %u lost ---\n\r",
+           played, done_events, played - done_events);
+    if (done_events > 0) {
+        qsort(latency_us, done_events, sizeof(latency_us[0]), compare_u32);
+        printk("Events/s (host time) : %u\n\r",
+               (uint32_t)(elapsed ? (uint64_t)done_events * 1000000u / elapsed : 0));
+        printk("Press to display (us): p50 %u  p90 %u  p99 %u  max %u\n\r",
+               percentile(50), percentile(90), percentile(99), latency_us[done_events - 1]);
+    }
+
+    posix_exit(0);
+}
+
+K_THREAD_DEFINE(replay_thread, REPLAY_STACK_SIZE, replay_thread_code, NULL, NULL, NULL,
+                REPLAY_PRIO, 0, SYS_FOREVER_MS);
+
+void replay_start(void)
+{
+    k_thread_start(replay_thread);
+}
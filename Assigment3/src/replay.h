@@ -0,0 +1,40 @@
+/** @file replay.h
+ * @brief Button trace replay and benchmark for the native_posix build.
+ *
+ * On native_posix the buttons are pins of the GPIO emulator (see
+ * native_posix.overlay). The replay thread presses and releases them with
+ * gpio_emul_input_set(), first following a recorded session and then a
+ * generated random trace, so the whole path (GPIO interrupt, debounce,
+ * queue, State Machine and display) runs as on the board.
+ * \n At the end it prints the events processed per second and the
+ * percentiles of the latency from the press to the end of display_flush(),
+ * measured with the host clock, and exits.
+ *
+ * Build and run:
+ * @verbatim
+   west build -b native_posix Assigment3
+   ./build/zephyr/zephyr.exe | tail -n 8
+   @endverbatim
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _replay_h
+#define _replay_h
+
+#define REPLAY_GENERATED_EVENTS 1000 /* Random presses after the recorded session */
+#define REPLAY_SEED 12345            /* Seed of the generated trace (same trace every run) */
+
+/**
+ * @brief Starts the replay thread. To be called after the buttons are configured.
+ */
+void replay_start(void);
+
+/**
+ * @brief Called by the State Machine after the display of one event is sent.
+ * Closes the latency measure of the oldest press.
+ */
+void replay_event_done(void);
+
+#endif
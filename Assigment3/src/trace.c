@@ -0,0 +1,78 @@
+/** @file trace.c
+ * @brief ISR safe binary trace of the button presses.
+ *
+ * Single producer / single consumer ring buffer: only the ISR writes
+ * trace_head and only the drain thread writes trace_tail, so no lock is
+ * needed. The drain thread sleeps on a semaphore that the ISR gives only
+ * when the buffer goes from empty to not empty.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#include "trace.h"
+
+#define TRACE_STACK_SIZE 1024
+#define TRACE_PRIO K_LOWEST_APPLICATION_THREAD_PRIO
+
+BUILD_ASSERT((TRACE_BUFFER_SIZE & (TRACE_BUFFER_SIZE - 1)) == 0, "TRACE_BUFFER_SIZE must be a power of 2");
+
+static struct trace_record trace_buf[TRACE_BUFFER_SIZE];
+static volatile uint32_t trace_head = 0; /* Next slot to write (ISR) */
+static volatile uint32_t trace_tail = 0; /* Next slot to read (drain thread) */
+static volatile uint32_t trace_lost = 0;
+
+K_SEM_DEFINE(trace_sem, 0, 1);
+
+void trace_isr(uint8_t id, timing_t edge)
+{
+    uint32_t head = trace_head;
+    uint32_t tail = trace_tail;
+
+    if (head - tail >= TRACE_BUFFER_SIZE) {
+        trace_lost++;
+        return;
+    }
+
+    trace_buf[head & (TRACE_BUFFER_SIZE - 1)].cycles = (uint32_t)edge;
+    trace_buf[head & (TRACE_BUFFER_SIZE - 1)].id = id;
+    compiler_barrier(); /* The record must be written before it is published */
+    trace_head = head + 1;
+
+    if (head == tail) {
+        k_sem_give(&trace_sem);
+    }
+}
+
+uint32_t trace_dropped(void)
+{
+    return trace_lost;
+}
+
+static void trace_thread_code(void *argA, void *argB, void *argC)
+{
+    struct trace_record rec;
+    uint32_t lost_reported = 0;
+
+    while (1) {
+        k_sem_take(&trace_sem, K_FOREVER);
+
+        while (trace_tail != trace_head) {
+            rec = trace_buf[trace_tail & (TRACE_BUFFER_SIZE - 1)];
+            compiler_barrier(); /* The record must be read before the slot is freed */
+            trace_tail = trace_tail + 1;
+
+            printk("But%d pressed at %u\n\r", rec.id, rec.cycles);
+        }
+
+        if (trace_lost != lost_reported) {
+            lost_reported = trace_lost;
+            printk("Trace: %u records lost\n\r", lost_reported);
+        }
+    }
+}
+
+K_THREAD_DEFINE(trace_thread, TRACE_STACK_SIZE, trace_thread_code, NULL, NULL, NULL, TRACE_PRIO, 0, 0);
@@ -0,0 +1,46 @@
+/** @file trace.h
+ * @brief ISR safe binary trace of the button presses.
+ *
+ * The button callbacks run in interrupt context, where printk would block
+ * on the UART. Instead they call trace_isr(), which only stores the button
+ * id and the time of its GPIO edge in a ring buffer. A low priority thread
+ * drains the buffer and prints the records later.
+ * \n The handler runs in the debounce scan timer, 5 to 20 ms after the press,
+ * so the time is not read there: it is the edge stamp that the buttons
+ * module takes in the GPIO interrupt (buttons_now()).
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _trace_h
+#define _trace_h
+
+#include <zephyr.h>
+#include <timing/timing.h>
+
+#define TRACE_BUFFER_SIZE 32 /* Records kept until printed, must be a power of 2 */
+
+/**
+ * @brief One record of the trace.
+ */
+struct trace_record {
+    uint32_t cycles; /**< Low 32 bits of buttons_now() at the GPIO edge */
+    uint8_t id;      /**< Button that was pressed */
+};
+
+/**
+ * @brief Adds a record to the trace. To be called from the button ISRs only
+ * (single producer). Never blocks; if the buffer is full the record is counted
+ * as dropped.
+ * @param id button that was pressed
+ * @param edge buttons_now() at the GPIO edge of the press
+ */
+void trace_isr(uint8_t id, timing_t edge);
+
+/**
+ * @brief Number of records lost because the buffer was full.
+ */
+uint32_t trace_dropped(void);
+
+#endif
@@ -0,0 +1,243 @@
+/** @file vending.c
+ * @brief State Machine of the vending machine, one context per machine.
+ *
+ * The actions and the UI of the machine. They only touch the context they
+ * are given and the const tables (catalog, coins, transitions), so two
+ * machines never share data.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <stddef.h>
+
+#include "catalog.h"
+#include "vending.h"
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#ifndef ARG_UNUSED
+#define ARG_UNUSED(x) (void)(x)
+#endif
+
+/* The change records store a coin count of the inventory in item, it must not be truncated */
+_Static_assert(sizeof(((struct journal_record *)0)->item) >= sizeof(((struct coin_box *)0)->count[0]),
+               "journal item too narrow for a coin count");
+
+static void show(struct vending *v, const char *fmt, ...)
+{
+  va_list args;
+
+  va_start(args, fmt);
+  v->ops->print(v->user, fmt, args);
+  va_end(args);
+}
+
+static void record(struct vending *v, enum journal_type type, uint16_t item, uint16_t amount)
+{
+  v->ops->record(v->user, type, item, amount);
+}
+
+static void returnCredit(struct vending *v, int arg)
+{
+  ARG_UNUSED(arg);
+  resetMoney(v);
+}
+
+static void selectProduct(struct vending *v, int arg)
+{
+  ARG_UNUSED(arg);
+  Check(v);
+}
+
+/* One transition: the state where the action runs, the action and the state to go back to */
+struct transition {
+  uint8_t state;
+  uint8_t next;
+  void (*action)(struct vending *v, int arg);
+  int arg;
+};
+
+/*
+ * Transition table (state x event -> action). It is const, so it stays in flash
+ * and every event is handled with one indexed lookup.
+ * S1..S4 are the states where the actions run; all of them go back to S0.
+ */
+static const struct transition fsm_table[NUM_STATES][NUM_EVENTS] = {
+  [S0] = {
+    [EVT_BUT1] = { S1, S0, addMoney, 10 },       /* "Add Money" State */
+    [EVT_BUT2] = { S1, S0, addMoney, 20 },
+    [EVT_BUT3] = { S1, S0, addMoney, 50 },
+    [EVT_BUT4] = { S1, S0, addMoney, 100 },
+    [EVT_BUT5] = { S3, S0, UpOrDown, 2 },        /* "Browse Up/Down" State */
+    [EVT_BUT6] = { S2, S0, returnCredit, 0 },    /* "Return Money" State */
+    [EVT_BUT7] = { S3, S0, UpOrDown, 1 },
+    [EVT_BUT8] = { S4, S0, selectProduct, 0 },   /* "Select Product" State */
+  },
+  /* S1..S4 are left right away, events never find the machine there */
+};
+
+void vending_init(struct vending *v, const struct vending_ops *ops, void *user,
+                  int credit, const uint16_t coins[COIN_TYPES])
+{
+  v->state = S0;
+  v->credit = credit;
+  v->choice = 0;
+  v->ops = ops;
+  v->user = user;
+  coins_set(&v->coins, coins);
+  loadFloat(v);
+}
+
+bool vending_event(struct vending *v, uint8_t event)
+{
+  const struct transition *t;
+
+  if(event >= NUM_EVENTS || v->state >= NUM_STATES)
+  {
+    v->state = S0; /* Return to Fundamental State*/
+    return false;
+  }
+
+  t = &fsm_table[v->state][event];
+  if(t->action == NULL)
+  {
+    return false; /* Event not used in this state */
+  }
+
+  v->state = t->state;
+  t->action(v, t->arg);
+  v->state = t->next;
+  return true;
+}
+
+void addMoney(struct vending *v, int cach)
+{
+  int coin = coin_index(cach);
+
+  if(coin < 0)
+  {
+    show(v, "Moeda nao aceite : %d Centimos", cach); /* Not a coin of the inventory, credit unchanged */
+    return;
+  }
+
+  v->credit = v->credit + cach;
+  coins_add(&v->coins, coin, 1);
+  record(v, JOURNAL_COIN, 0, cach);
+  showMenu(v, 0);
+  showSpace(v);
+  show(v, "Dinheiro adicionado : %d Centimos", cach);
+  show(v, "Dinheiro Atual : %d Centimos", v->credit);
+}
+
+void resetMoney(struct vending *v)
+{
+  uint16_t change[COIN_TYPES];
+  int refund = coins_change(&v->coins, v->credit, change); /* Only what the coins in the machine can pay */
+
+  showMenu(v, 0);
+  showSpace(v);
+  show(v, "Dinheiro devolvido : %d Centimos", refund);
+  if(refund > 0)
+  {
+    show(v, "Moedas : %dx100 %dx50 %dx20 %dx10", change[3], change[2], change[1], change[0]);
+    coins_remove(&v->coins, change);
+    record(v, JOURNAL_REFUND, 0, refund);
+    for(int i = 0; i < COIN_TYPES; i++)
+    {
+      if(change[i] > 0) record(v, JOURNAL_CHANGE, change[i], coin_value[i]);
+    }
+  }
+  v->credit = v->credit - refund;
+  if(v->credit > 0)
+  {
+    show(v, "Sem troco para %d Centimos", v->credit);
+  }
+  show(v, "Dinheiro Atual : %d Centimos", v->credit);
+}
+
+void loadFloat(struct vending *v)
+{
+  for(int i = 0; i < COIN_TYPES; i++)
+  {
+    if(coins_count(&v->coins, i) != 0) return;
+  }
+
+  for(int i = 0; i < COIN_TYPES; i++)
+  {
+    if(coins_float[i] == 0) continue;
+    coins_add(&v->coins, i, coins_float[i]);
+    record(v, JOURNAL_FILL, coins_float[i], coin_value[i]);
+  }
+}
+
+void UpOrDown(struct vending *v, int flag)
+{
+  if(flag == 1)
+  {
+    v->choice = v->choice + 1;
+    if(v->choice >= catalog_size) v->choice = 0;
+  } else if (flag == 2)
+  {
+    v->choice = v->choice - 1;
+    if(v->choice < 0) v->choice = catalog_size - 1;
+  }
+  showMenu(v, 1);
+}
+
+void Check(struct vending *v)
+{
+  const struct product *p = catalog_get(v->choice);
+
+  if(p == NULL)
+  {
+    return;
+  }
+
+  if(v->credit >= p->price)
+  {
+    v->credit = v->credit - p->price;
+    record(v, JOURNAL_SALE, v->choice, p->price);
+    showMenu(v, 0);
+    showSpace(v);
+    show(v, "Produto Entregue (%s)", p->name);
+    show(v, "Dinheiro Descontado: %d Centimos", p->price);
+    show(v, "Dinheiro Atual : %d Centimos", v->credit);
+  } else
+  {
+    showMenu(v, 0);
+    showSpace(v);
+    show(v, "Custo do Produto : %d Centimos", p->price);
+    show(v, "Dinheiro que Falta: %d Centimos",(p->price - v->credit));
+    show(v, "Dinheiro Atual : %d Centimos", v->credit);
+  }
+}
+
+void showMenu(struct vending *v, int flag)
+{
+  int page = catalog_page(v->choice);
+  int first = page * CATALOG_PAGE_SIZE;
+  int last = MIN(first + CATALOG_PAGE_SIZE, catalog_size);
+
+  v->ops->clear(v->user);
+  show(v, "Products (%d/%d) : ", page + 1, catalog_pages());
+  for(int i = first; i < last; i++)
+  {
+    show(v, "   - %s : %d Centimos%s", catalog[i].name, catalog[i].price,
+         (i == v->choice) ? "     <---- " : " ");
+  }
+  if(flag == 1)
+  {
+    showSpace(v);
+    show(v, "Dinheiro Atual : %d Centimos", v->credit);
+  }
+}
+
+void showSpace(struct vending *v)
+{
+  show(v, " ");
+  show(v, "----------------------------------------------------");
+  show(v, " ");
+}
@@ -0,0 +1,182 @@
+/** @file vending.h
+ * @brief State Machine of the vending machine, one context per machine.
+ *
+ * Everything one machine needs (state, credit, highlighted product and
+ * coins) is in struct vending, and every function takes the context, so
+ * any number of machines can run at the same time.
+ * \n This file does not depend on Zephyr. The output goes through struct
+ * vending_ops: on the board it is the display and the flash journal
+ * (main.c), in the host fleet harness it is a buffer and counters
+ * (host/fleet.c).
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _vending_h
+#define _vending_h
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "coins.h"
+#include "journal.h"
+
+/* Define States*/
+
+#define S0 0
+#define S1 1
+#define S2 2
+#define S3 3
+#define S4 4
+#define NUM_STATES 5
+
+/* Button events, consumed by the State Machine */
+enum button_id {
+    EVT_BUT1 = 0, /* Coin of 10 cents */
+    EVT_BUT2,     /* Coin of 20 cents */
+    EVT_BUT3,     /* Coin of 50 cents */
+    EVT_BUT4,     /* Coin of 100 cents */
+    EVT_BUT5,     /* Browse Up */
+    EVT_BUT6,     /* Return Credit */
+    EVT_BUT7,     /* Browse Down */
+    EVT_BUT8,     /* Select Product */
+    NUM_EVENTS
+};
+
+/**
+ * @brief Output of one machine.
+ */
+struct vending_ops {
+    /** Starts a new frame of the UI */
+    void (*clear)(void *user);
+    /** Adds one line to the frame */
+    void (*print)(void *user, const char *fmt, va_list args);
+    /** Records one transaction (same arguments as journal_add()) */
+    void (*record)(void *user, enum journal_type type, uint16_t item, uint16_t amount);
+};
+
+/**
+ * @brief Context of one machine.
+ */
+struct vending {
+    uint8_t state;                 /**< State of the State Machine (S0..S4) */
+    int credit;                    /**< Credit of the client, in cents */
+    int choice;                    /**< Index of the highlighted product in the catalog */
+    struct coin_box coins;         /**< Coins held by the machine */
+    const struct vending_ops *ops; /**< Output of the machine */
+    void *user;                    /**< Passed to the ops */
+};
+
+/**
+ * @brief Prepares a machine in state S0. If it has no coins the float
+ * (coins_float[]) is loaded and recorded.
+ *
+ * @param v context of the machine
+ * @param ops output of the machine
+ * @param user passed to the ops
+ * @param credit credit left from before (0 for a new machine)
+ * @param coins coins held by the machine
+ */
+void vending_init(struct vending *v, const struct vending_ops *ops, void *user,
+                  int credit, const uint16_t coins[COIN_TYPES]);
+
+/**
+ * @brief Handles one button event with one lookup in the transition table
+ * (state x event) and runs its action.
+ * @return true if the event changed the UI
+ */
+bool vending_event(struct vending *v, uint8_t event);
+
+/**
+ * @brief Adds the value chosen to the credit of the user.
+ * \n The coin goes to the coin inventory and is recorded in the journal.
+ * A value that is not an accepted coin (coin_index() < 0) is rejected and the credit is not changed.
+ *
+ * @code
+ * v->credit = v->credit + cach;
+ * coins_add(&v->coins, coin, 1);
+ * record(v, JOURNAL_COIN, 0, cach);
+ * @endcode
+ */
+void addMoney(struct vending *v, int cach);
+
+/**
+ * @brief Returns the credit from the vending machine, with the coins it holds.
+ * \n The coins are chosen by coins_change(); if there is no exact change the
+ * part that cannot be paid stays as credit, so the machine never promises change it does not have.
+ * \n The refund and the coins given are recorded in the journal.
+ *
+ * @code
+ * int refund = coins_change(&v->coins, v->credit, change);
+ * show(v, "Dinheiro devolvido : %d Centimos", refund);
+ * coins_remove(&v->coins, change);
+ * v->credit = v->credit - refund;
+ * @endcode
+ */
+void resetMoney(struct vending *v);
+
+/**
+ * @brief Loads the coins of coins_float[] when the machine has no coins
+ * (first boot), so it can give change from the start.
+ */
+void loadFloat(struct vending *v);
+
+/**
+ * @brief The purpose of this function is to rotate the selection of the highlighted product.
+ * \n The selection is the index of the product in the catalog and wraps around at both ends.
+ *
+ * @param v context of the machine
+ * @param flag 1 moves down the list, 2 moves up
+ */
+void UpOrDown(struct vending *v, int flag);
+
+/**
+ * @brief This function is in charge of the logic to
+ * identify and calculate if the credit is enough to buy the product chosen
+ * and inform the user according to that.
+ * \n The product is taken directly from the catalog table, so the check
+ * takes the same time for any number of products.
+ *
+ * @code
+ *  const struct product *p = catalog_get(v->choice);
+ *
+ *  if(v->credit >= p->price)
+ *  {
+ *    v->credit = v->credit - p->price;
+ *    record(v, JOURNAL_SALE, v->choice, p->price);
+ *    show(v, "Produto Entregue (%s)", p->name);
+ *  } else
+ *  {
+ *    show(v, "Dinheiro que Falta: %d Centimos",(p->price - v->credit));
+ *  }
+ * @endcode
+ */
+void Check(struct vending *v);
+
+/**
+ * @brief Main function of the UI for the products. This function is called in all the others.
+ * \n It starts a new frame with the page of the catalog where the highlighted product is
+ * (CATALOG_PAGE_SIZE products per page).
+ *
+ * This is the product options presented for the user:
+ * @verbatim
+  Products (1/1) :
+    - Beer : 150 Centimos     <----
+    - Tuna Sandwich : 100 Centimos
+    - Coffee : 50 Centimos
+  @endverbatim
+ *
+ * @param v context of the machine
+ * @param flag 1 also shows the current credit
+ */
+void showMenu(struct vending *v, int flag);
+
+/**
+ * @brief Function that allows the separation of the menu from the other functions.
+ * \n Used for a better UI.
+ */
+void showSpace(struct vending *v);
+
+#endif
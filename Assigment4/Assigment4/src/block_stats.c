@@ -0,0 +1,71 @@
+/** @file block_stats.c
+ * @brief Mean and variance of a block of samples.
+ *
+ * Both versions remove the rounded mean before squaring, so they give the
+ * same results to the count.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <errno.h>
+
+#ifdef CONFIG_BLOCK_STATS_CMSIS
+#include <arm_math.h>
+#endif
+
+#include "block_stats.h"
+
+int block_stats_scalar(const uint16_t *block, uint32_t n, struct block_stats *stats)
+{
+    uint64_t power = 0;
+    uint32_t sum = 0, i;
+    int32_t d;
+
+    if (n < 2 || n > BLOCK_STATS_MAX) {
+        return -EINVAL;
+    }
+
+    for (i = 0; i < n; i++) {
+        sum += block[i];
+    }
+    stats->mean = sum / n;
+
+    for (i = 0; i < n; i++) {
+        d = (int32_t)block[i] - stats->mean;
+        power += d * d;
+    }
+    stats->variance = power / (n - 1);
+    return 0;
+}
+
+#ifdef CONFIG_BLOCK_STATS_CMSIS
+
+static q15_t centered[BLOCK_STATS_MAX]; /* Samples minus the mean */
+
+int block_stats(const uint16_t *block, uint32_t n, struct block_stats *stats)
+{
+    q15_t mean;
+    q63_t power;
+
+    if (n < 2 || n > BLOCK_STATS_MAX) {
+        return -EINVAL;
+    }
+
+    arm_mean_q15((const q15_t *)block, n, &mean);
+    arm_offset_q15((const q15_t *)block, -mean, centered, n);
+    arm_power_q15(centered, n, &power);
+
+    stats->mean = mean;
+    stats->variance = (uint64_t)power / (n - 1);
+    return 0;
+}
+
+#else
+
+int block_stats(const uint16_t *block, uint32_t n, struct block_stats *stats)
+{
+    return block_stats_scalar(block, n, stats);
+}
+
+#endif
@@ -0,0 +1,54 @@
+/** @file block_stats.h
+ * @brief Mean and variance of a block of samples.
+ *
+ * Used on the blocks of the burst mode, which are plain (not volatile)
+ * contiguous buffers. With CONFIG_BLOCK_STATS_CMSIS the work is done by CMSIS-DSP,
+ * which on the Cortex-M4 uses the SIMD instructions (two q15 samples per
+ * instruction):
+ * - arm_mean_q15() for the mean,
+ * - arm_offset_q15() to remove it from the samples,
+ * - arm_power_q15() for the sum of the squares, kept exact in 64 bits.
+ *
+ * arm_var_q15() is not used: its result is in q15, so for 10 bit samples
+ * the variance would come in steps of 32 counts^2, more than the noise of
+ * the potentiometer.
+ * \n The raw samples (0 to 1023) are valid q15 values as they are.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _block_stats_h
+#define _block_stats_h
+
+#include <stdint.h>
+
+#define BLOCK_STATS_MAX 1024 /* Largest block */
+
+/**
+ * @brief Statistics of a block.
+ */
+struct block_stats {
+    uint16_t mean;     /**< Mean, rounded down */
+    uint32_t variance; /**< Sample variance around the mean above, in counts^2 */
+};
+
+/**
+ * @brief Mean and variance with CMSIS-DSP, or block_stats_scalar() without it.
+ * @param block samples, 0 to 1023
+ * @param n number of samples, 2 to BLOCK_STATS_MAX
+ * @param stats set to the results
+ * @return 0 on success, -EINVAL if n is out of range
+ */
+int block_stats(const uint16_t *block, uint32_t n, struct block_stats *stats);
+
+/**
+ * @brief Same results as block_stats(), in plain C loops.
+ * @param block samples, 0 to 1023
+ * @param n number of samples, 2 to BLOCK_STATS_MAX
+ * @param stats set to the results
+ * @return 0 on success, -EINVAL if n is out of range
+ */
+int block_stats_scalar(const uint16_t *block, uint32_t n, struct block_stats *stats);
+
+#endif
@@ -0,0 +1,293 @@
+/** @file filters.h
+ * @brief Filter chain of thread B.
+ *
+ * Every sample goes through the stages enabled in Kconfig (menu
+ * "Filter chain of thread B"), always in this order:
+ * -# median of the last CONFIG_FILTER_MEDIAN_SIZE samples, removes spikes,
+ * -# mean of the window without the samples more than 10% away from its
+ *    mean (the original filter, window.h),
+ * -# exponential moving average, alpha = 1 / 2^CONFIG_FILTER_EMA_SHIFT,
+ * -# biquad IIR low-pass, Butterworth with the cut-off at 1/10 of the
+ *    sampling rate,
+ * -# scalar Kalman filter of a constant level with process noise
+ *    CONFIG_FILTER_KALMAN_Q and measurement noise CONFIG_FILTER_KALMAN_R.
+ *
+ * The stages are static inline functions called one after the other in
+ * filter_chain_step(), so the chain is decided at compile time: there are
+ * no function pointers and a stage that is not enabled is not built at
+ * all. All of them use integer arithmetic only and start from zero, like
+ * the window did.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _filters_h
+#define _filters_h
+
+#include <stdint.h>
+#include <string.h>
+
+#include "fixed.h"
+#include "sampler.h"
+#ifdef CONFIG_FILTER_TRIMMED_MEAN
+#include "window.h"
+#endif
+
+/* Keeps a result in the raw range */
+static inline uint16_t filter_clamp(int32_t x)
+{
+    if (x < 0) {
+        return 0;
+    }
+    return (x > SAMPLER_MAX) ? SAMPLER_MAX : x;
+}
+
+/* ######################################## Median ######################################## */
+
+#ifdef CONFIG_FILTER_MEDIAN
+
+#define MEDIAN_SIZE CONFIG_FILTER_MEDIAN_SIZE
+
+struct filter_median {
+    uint16_t ring[MEDIAN_SIZE];   /* Samples in arrival order */
+    uint16_t sorted[MEDIAN_SIZE]; /* Same samples in increasing order */
+    uint16_t head;                /* Oldest sample */
+};
+
+static inline void filter_median_init(struct filter_median *f)
+{
+    memset(f, 0, sizeof(*f));
+}
+
+static inline uint16_t filter_median_step(struct filter_median *f, uint16_t x)
+{
+    uint16_t old = f->ring[f->head];
+    int i = 0;
+
+    f->ring[f->head] = x;
+    f->head = (f->head + 1 == MEDIAN_SIZE) ? 0 : f->head + 1;
+
+    /* The oldest sample leaves the sorted array, then the new one slides to its place */
+    while (f->sorted[i] != old) {
+        i++;
+    }
+    while (i > 0 && f->sorted[i - 1] > x) {
+        f->sorted[i] = f->sorted[i - 1];
+        i--;
+    }
+    while (i < MEDIAN_SIZE - 1 && f->sorted[i + 1] < x) {
+        f->sorted[i] = f->sorted[i + 1];
+        i++;
+    }
+    f->sorted[i] = x;
+
+    return f->sorted[MEDIAN_SIZE / 2];
+}
+
+#endif
+
+/* ##################################### Trimmed mean ##################################### */
+
+#ifdef CONFIG_FILTER_TRIMMED_MEAN
+
+struct filter_trimmed {
+    struct window window;
+    uint16_t media;  /* Mean of the window */
+    uint16_t desvio; /* 10% of the mean */
+    uint32_t count;  /* Samples inside media +- desvio */
+};
+
+static inline void filter_trimmed_init(struct filter_trimmed *f)
+{
+    window_init(&f->window);
+    f->media = 0;
+    f->desvio = 0;
+    f->count = 0;
+}
+
+static inline uint16_t filter_trimmed_step(struct filter_trimmed *f, uint16_t x)
+{
+    uint32_t sum;
+
+    window_add(&f->window, x);
+    f->media = window_mean(&f->window);
+    f->desvio = fixed_tenth(f->media);
+
+    /* Samples strictly inside media +- desvio */
+    f->count = window_range(&f->window, f->media - f->desvio + 1, f->media + f->desvio - 1, &sum);
+
+    return (f->count != 0) ? sum / f->count : 0;
+}
+
+#endif
+
+/* ######################################### EMA ########################################## */
+
+#ifdef CONFIG_FILTER_EMA
+
+struct filter_ema {
+    int32_t acc; /* Average in Q8 */
+};
+
+static inline void filter_ema_init(struct filter_ema *f)
+{
+    f->acc = 0;
+}
+
+static inline uint16_t filter_ema_step(struct filter_ema *f, uint16_t x)
+{
+    f->acc += (((int32_t)x << 8) - f->acc) >> CONFIG_FILTER_EMA_SHIFT;
+    return filter_clamp((f->acc + 128) >> 8);
+}
+
+#endif
+
+/* ######################################## Biquad ######################################## */
+
+#ifdef CONFIG_FILTER_BIQUAD
+
+/* Coefficients in Q14 (a0 = 1), DC gain exactly 1: (b0 + b1 + b2) = (1 + a1 + a2) */
+#define BIQUAD_B0 1105
+#define BIQUAD_B1 2210
+#define BIQUAD_B2 1105
+#define BIQUAD_A1 -18727
+#define BIQUAD_A2 6763
+
+/* Samples are kept in Q4, so the rounding of the feedback stays below a raw count */
+struct filter_biquad {
+    int32_t x1, x2; /* Last inputs */
+    int32_t y1, y2; /* Last outputs */
+};
+
+static inline void filter_biquad_init(struct filter_biquad *f)
+{
+    memset(f, 0, sizeof(*f));
+}
+
+static inline uint16_t filter_biquad_step(struct filter_biquad *f, uint16_t x)
+{
+    int32_t in = (int32_t)x << 4;
+    int32_t acc, y;
+
+    /* Direct form I, largest sum about 5 * 10^8 */
+    acc = BIQUAD_B0 * in + BIQUAD_B1 * f->x1 + BIQUAD_B2 * f->x2
+        - BIQUAD_A1 * f->y1 - BIQUAD_A2 * f->y2;
+    y = (acc + (1 << 13)) >> 14;
+
+    f->x2 = f->x1;
+    f->x1 = in;
+    f->y2 = f->y1;
+    f->y1 = y;
+
+    return filter_clamp((y + 8) >> 4);
+}
+
+#endif
+
+/* ######################################## Kalman ######################################## */
+
+#ifdef CONFIG_FILTER_KALMAN
+
+#define KALMAN_Q ((uint32_t)CONFIG_FILTER_KALMAN_Q << 8) /* Process noise, Q8 */
+#define KALMAN_R ((uint32_t)CONFIG_FILTER_KALMAN_R << 8) /* Measurement noise, Q8 */
+
+struct filter_kalman {
+    int32_t x;  /* Estimate, Q8 */
+    uint32_t p; /* Its variance, Q8 */
+};
+
+static inline void filter_kalman_init(struct filter_kalman *f)
+{
+    f->x = 0;
+    f->p = KALMAN_R;
+}
+
+static inline uint16_t filter_kalman_step(struct filter_kalman *f, uint16_t z)
+{
+    uint32_t k;
+
+    f->p += KALMAN_Q;
+    k = ((uint64_t)f->p << 16) / (f->p + KALMAN_R); /* Gain, Q16 */
+    f->x += ((int64_t)k * (((int32_t)z << 8) - f->x)) >> 16;
+    f->p = ((uint64_t)(65536 - k) * f->p) >> 16;
+
+    return filter_clamp((f->x + 128) >> 8);
+}
+
+#endif
+
+/* ######################################## Chain ######################################### */
+
+/**
+ * @brief State of the enabled stages.
+ */
+struct filter_chain {
+#ifdef CONFIG_FILTER_MEDIAN
+    struct filter_median median;
+#endif
+#ifdef CONFIG_FILTER_TRIMMED_MEAN
+    struct filter_trimmed trimmed;
+#endif
+#ifdef CONFIG_FILTER_EMA
+    struct filter_ema ema;
+#endif
+#ifdef CONFIG_FILTER_BIQUAD
+    struct filter_biquad biquad;
+#endif
+#ifdef CONFIG_FILTER_KALMAN
+    struct filter_kalman kalman;
+#endif
+    uint8_t unused; /* Keeps the struct valid with no stage */
+};
+
+/**
+ * @brief Sets every stage as if it had seen only zeros.
+ * @param c chain
+ */
+static inline void filter_chain_init(struct filter_chain *c)
+{
+#ifdef CONFIG_FILTER_MEDIAN
+    filter_median_init(&c->median);
+#endif
+#ifdef CONFIG_FILTER_TRIMMED_MEAN
+    filter_trimmed_init(&c->trimmed);
+#endif
+#ifdef CONFIG_FILTER_EMA
+    filter_ema_init(&c->ema);
+#endif
+#ifdef CONFIG_FILTER_BIQUAD
+    filter_biquad_init(&c->biquad);
+#endif
+#ifdef CONFIG_FILTER_KALMAN
+    filter_kalman_init(&c->kalman);
+#endif
+}
+
+/**
+ * @brief Passes one sample through the chain.
+ * @param c chain
+ * @param x raw sample, 0 to 1023
+ * @return filtered value, 0 to 1023 (the sample itself with no stage)
+ */
+static inline uint16_t filter_chain_step(struct filter_chain *c, uint16_t x)
+{
+#ifdef CONFIG_FILTER_MEDIAN
+    x = filter_median_step(&c->median, x);
+#endif
+#ifdef CONFIG_FILTER_TRIMMED_MEAN
+    x = filter_trimmed_step(&c->trimmed, x);
+#endif
+#ifdef CONFIG_FILTER_EMA
+    x = filter_ema_step(&c->ema, x);
+#endif
+#ifdef CONFIG_FILTER_BIQUAD
+    x = filter_biquad_step(&c->biquad, x);
+#endif
+#ifdef CONFIG_FILTER_KALMAN
+    x = filter_kalman_step(&c->kalman, x);
+#endif
+    return x;
+}
+
+#endif
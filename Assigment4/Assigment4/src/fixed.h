@@ -0,0 +1,54 @@
+/** @file fixed.h
+ * @brief Integer arithmetic of the pipeline.
+ *
+ * The divisions by constants are multiplications by the reciprocal in
+ * fixed point followed by a shift:
+ * - raw to mV, 3000 / 1023 in Q18. Q16 is off by 1 mV for one raw value,
+ *   Q18 gives floor(3000 * raw / 1023), the same as the float code, for
+ *   every raw value (0 to 1023) and still fits in 32 bits.
+ * - 0.1, in Q15, exact for every value up to 1023.
+ *
+ * The nRF52840 builds have no FPU enabled, so every float operation was a
+ * call to the soft float library.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _fixed_h
+#define _fixed_h
+
+#include <stdint.h>
+
+#define FIXED_MV_Q18 768751u  /* 3000 / 1023 in Q18, rounded up */
+#define FIXED_TENTH_Q15 3277u /* 0.1 in Q15, rounded up */
+
+/**
+ * @brief Converts a raw ADC value to mV.
+ * @param raw value from 0 to 1023
+ * @return voltage in mV, from 0 to 3000
+ */
+static inline uint16_t fixed_raw_to_mv(uint16_t raw)
+{
+    return ((uint32_t)raw * FIXED_MV_Q18) >> 18;
+}
+
+/**
+ * @brief Tenth of a value, rounded down.
+ * @param x value from 0 to 1023
+ * @return x / 10
+ */
+static inline uint16_t fixed_tenth(uint16_t x)
+{
+    return ((uint32_t)x * FIXED_TENTH_Q15) >> 15;
+}
+
+#ifdef CONFIG_FIXED_POINT_BENCH
+/**
+ * @brief Times the conversions of all raw values in float and in fixed point, checks that they
+ * give the same results and prints the cycles per conversion.
+ */
+void fixed_bench(void);
+#endif
+
+#endif
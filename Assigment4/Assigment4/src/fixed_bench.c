@@ -0,0 +1,63 @@
+/** @file fixed_bench.c
+ * @brief Cycle count of the float and fixed point conversions.
+ *
+ * Built with CONFIG_FIXED_POINT_BENCH; main() runs it once at boot,
+ * before the threads start. The float expressions are the ones the
+ * pipeline used before fixed.h.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+#include <timing/timing.h>
+
+#include "fixed.h"
+#include "sampler.h"
+
+#define BENCH_ROUNDS 10 /* Times every raw value is converted */
+
+static volatile uint16_t sink; /* Keeps the results from being optimized away */
+
+void fixed_bench(void)
+{
+    timing_t start, end;
+    uint64_t float_cycles, fixed_cycles;
+    uint32_t raw, round, conversions, errors = 0;
+
+    timing_init();
+    timing_start();
+
+    for (raw = 0; raw <= SAMPLER_MAX; raw++) {
+        if ((uint16_t)(1000 * raw * ((float)3 / 1023)) != fixed_raw_to_mv(raw) ||
+            (uint16_t)(0.1 * raw) != fixed_tenth(raw)) {
+            errors++;
+        }
+    }
+
+    start = timing_counter_get();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        for (raw = 0; raw <= SAMPLER_MAX; raw++) {
+            sink = (uint16_t)(1000 * raw * ((float)3 / 1023));
+            sink = (uint16_t)(0.1 * raw);
+        }
+    }
+    end = timing_counter_get();
+    float_cycles = timing_cycles_get(&start, &end);
+
+    start = timing_counter_get();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        for (raw = 0; raw <= SAMPLER_MAX; raw++) {
+            sink = fixed_raw_to_mv(raw);
+            sink = fixed_tenth(raw);
+        }
+    }
+    end = timing_counter_get();
+    fixed_cycles = timing_cycles_get(&start, &end);
+
+    conversions = BENCH_ROUNDS * (SAMPLER_MAX + 1);
+    printk("\n\r--- Fixed point bench: %u samples (mV + tenth) ---\n\r", conversions);
+    printk("float: %u cycles/sample  fixed: %u cycles/sample  different results: %u\n\r",
+           (uint32_t)(float_cycles / conversions), (uint32_t)(fixed_cycles / conversions), errors);
+}
@@ -51,67 +51,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "sampler.h" /* ADC acquisition */
+#include "filters.h" /* Filter chain of thread B */
+#include "fixed.h"   /* Integer conversions */
+#include "stage_stats.h" /* Timing of the stages */
+#ifdef CONFIG_SAMPLER_BURST
+#include "block_stats.h" /* Mean and variance of a block */
+#endif
 
 
-/* ########################################################################################################################################## */
-/* ##################################                            ADC DEFINITIONS                           ##################################*/
-/* ########################################################################################################################################## */
-
-#include <hal/nrf_saadc.h>
-#define ADC_NID DT_NODELABEL(adc) 
-#define ADC_RESOLUTION 10
-#define ADC_GAIN ADC_GAIN_1_4
-#define ADC_REFERENCE ADC_REF_VDD_1_4
-#define ADC_ACQUISITION_TIME ADC_ACQ_TIME(ADC_ACQ_TIME_MICROSECONDS, 40)
-#define ADC_CHANNEL_ID 1  
-
-
-#define ADC_CHANNEL_INPUT NRF_SAADC_INPUT_AIN1 
-
-#define BUFFER_SIZE 1
-
-/* Other defines */
-#define TIMER_INTERVAL_MSEC 10000 /* Interval between ADC samples */
-
-/* ADC channel configuration */
-static const struct adc_channel_cfg my_channel_cfg = {
-	.gain = ADC_GAIN,
-	.reference = ADC_REFERENCE,
-	.acquisition_time = ADC_ACQUISITION_TIME,
-	.channel_id = ADC_CHANNEL_ID,
-	.input_positive = ADC_CHANNEL_INPUT
-};
-
-/* Global vars for ADC */
-struct k_timer my_timer;
-const struct device *adc_dev = NULL;
-static uint16_t adc_sample_buffer[BUFFER_SIZE];
-
-
-/* Takes one sample */
-static int adc_sample(void)
-{
-	int ret;
-	const struct adc_sequence sequence = {
-		.channels = BIT(ADC_CHANNEL_ID),
-		.buffer = adc_sample_buffer,
-		.buffer_size = sizeof(adc_sample_buffer),
-		.resolution = ADC_RESOLUTION,
-	};
-
-	if (adc_dev == NULL) {
-            printk("adc_sample(): error, must bind to adc first \n\r");
-            return -1;
-	}
-
-	ret = adc_read(adc_dev, &sequence);
-	if (ret) {
-            printk("adc_read() failed with code %d\n", ret);
-	}	
-
-	return ret;
-}
-
 
 /* ########################################################################################################################################## */
 /* ##################################                            PWM DEFINITIONS                           ##################################*/
@@ -135,6 +83,7 @@ static int adc_sample(void)
 /*#define thread_B_period 10000*/
 /*#define thread_C_period 10000*/
 
+#ifdef CONFIG_PIPELINE_THREADS
 K_THREAD_STACK_DEFINE(thread_A_stack, STACK_SIZE);
 K_THREAD_STACK_DEFINE(thread_B_stack, STACK_SIZE);
 K_THREAD_STACK_DEFINE(thread_C_stack, STACK_SIZE);
@@ -146,47 +95,82 @@ struct k_thread thread_C_data;
 k_tid_t thread_A_tid;
 k_tid_t thread_B_tid;
 k_tid_t thread_C_tid;
+#endif
 
 void thread_A_code(void *argA, void *argB, void *argC);
 void thread_B_code(void *argA, void *argB, void *argC);
 void thread_C_code(void *argA, void *argB, void *argC);
 
+int stage_A_sample(void);
+void stage_B_filter(void);
+int stage_C_init(void);
+int stage_C_actuate(void);
+
 /* Semaphores */
 int var_ab = 0;
 int var_bc = 0;
 
+/* Samples read by thread A; in the burst mode a whole block, valid until the next block is complete */
+const uint16_t *block_ab = NULL;
+int block_ab_len = 0;
+
 struct k_sem sem_ab;
 struct k_sem sem_bc;
 
+/* When the sample was handed over, the release of the next stage */
+timing_t release_ab;
+timing_t release_bc;
+
 /*############*/
 
 /* ########################################################################################################################################## */
 /* ###################################                         GLOBAL VARIABLES                           ###################################*/
 /* ########################################################################################################################################## */
 
-#define WINDOW_SIZE 10
+/* Stages chosen in Kconfig, they start as if they had seen only zeros */
+static struct filter_chain chain;
 
-volatile uint16_t media = 0;
-volatile uint16_t buffer[WINDOW_SIZE] = {0,0,0,0,0,0,0,0,0,0};
-volatile uint16_t media_2 = 0;
-volatile uint16_t desvio = 0;
+/* Devices of stage C */
+static const struct device *gpio0_dev;
+static const struct device *pwm0_dev;
+
+static const unsigned int pwmPeriod_us = 250000;
+
+#ifdef CONFIG_PIPELINE_RUN_TO_COMPLETION
+/* Run to completion: every period the timer submits the work item, which calls the three stages */
+static void pipeline_work_handler(struct k_work *work);
+static void pipeline_timer_handler(struct k_timer *timer);
+
+static timing_t pipeline_release;
+
+K_WORK_DEFINE(pipeline_work, pipeline_work_handler);
+K_TIMER_DEFINE(pipeline_timer, pipeline_timer_handler, NULL);
+#endif
 
 
 void main(void)
 {    
     int err=0;   
-    /* ADC setup: bind and initialize */
-    adc_dev = device_get_binding(DT_LABEL(ADC_NID));
-	if (!adc_dev) {
-        printk("ADC device_get_binding() failed\n");
-    } 
-    err = adc_channel_setup(adc_dev, &my_channel_cfg);
+    /* ADC setup: bind, initialize and calibrate */
+    err = sampler_init();
     if (err) {
-        printk("adc_channel_setup() failed with error code %d\n", err);
+        printk("sampler_init() failed with error code %d\n\r", err);
     }
-    
-    NRF_SAADC->TASKS_CALIBRATEOFFSET = 1;
 
+#ifdef CONFIG_FIXED_POINT_BENCH
+    fixed_bench();
+#endif
+
+    filter_chain_init(&chain);
+    stage_stats_init();
+
+#ifdef CONFIG_PIPELINE_RUN_TO_COMPLETION
+    /*################### Periodic work item #####################*/
+    if (stage_C_init() == 0) {
+        k_timer_start(&pipeline_timer, K_NO_WAIT, K_MSEC(thread_A_period));
+    }
+    /*##############################################################*/
+#else
     /*###################### Semaphore Creation #####################*/
     k_sem_init(&sem_ab, 0, 1);
     k_sem_init(&sem_bc, 0, 1);
@@ -207,10 +191,160 @@ void main(void)
         NULL, NULL, NULL, thread_C_prio, 0, K_NO_WAIT);
 
     /*##############################################################*/
+#endif
     
     
     return;
 }
+/* ########################################################################################################################################## */
+/* ##################################                          STAGE IMPLEMENTATION                        ##################################*/
+/* ########################################################################################################################################## */
+
+/* ###################    STAGE A    ######################*/
+
+int stage_A_sample(void)
+{
+  int count;
+  int i;
+  const uint16_t *samples;
+
+  block_ab_len = 0;
+  count = sampler_read(&samples);
+  if (count < 0) 
+  {
+    printk("sampler_read() failed with error code %d\n\r", count);
+    return count;
+  } 
+
+  for (i = 0; i < count && samples[i] <= SAMPLER_MAX; i++);
+
+  if (i < count) 
+  {
+    printk("adc reading out of range\n\r");
+    return -ERANGE;
+  } 
+
+  block_ab = samples;
+  block_ab_len = count;
+  var_ab = samples[count - 1];
+  printk("adc reading  raw: %4u / %4u mV: (%d samples)\n\r", var_ab, fixed_raw_to_mv(var_ab), count);
+  return 0;
+}
+
+/* ###################    STAGE B    ######################*/
+
+void stage_B_filter(void)
+{
+  int n;
+#ifdef CONFIG_SAMPLER_BURST
+  struct block_stats stats;
+#endif
+
+  /* Every sample goes through the chain, the output of the last one goes to stage C */
+  for (n = 0; n < block_ab_len; n++) 
+  {
+    var_bc = filter_chain_step(&chain, block_ab[n]);
+  }
+
+  printk("adc reading filtered: raw:%4u / %4u mV: \n\r", var_bc, fixed_raw_to_mv(var_bc));
+
+#ifdef CONFIG_SAMPLER_BURST
+  /* Spread of the block, the noise seen by the filters */
+  if (block_stats(block_ab, block_ab_len, &stats) == 0) 
+  {
+    printk("block: mean %4u variance %u\n\r", stats.mean, stats.variance);
+  }
+#endif
+}
+
+/* ###################    STAGE C    ######################*/
+
+int stage_C_init(void)
+{
+  int ret = 0;
+
+  gpio0_dev = device_get_binding(DT_LABEL(GPIO0_NID));
+
+  if (gpio0_dev == NULL) {
+    printk("Error: Failed to bind to GPIO0\n\r");
+    return -ENODEV;
+  } else {
+    printk("Bind to GPIO0 successfull \n\r");
+  }
+
+  ret = gpio_pin_configure(gpio0_dev, BOARDLED_PIN, GPIO_OUTPUT_ACTIVE);
+  if (ret < 0) {
+    printk("gpio_pin_configure() failed with error %d\n\r", ret);
+    return ret;
+  }
+
+  pwm0_dev = device_get_binding(DT_LABEL(PWM0_NID));
+
+  if (pwm0_dev == NULL) {
+    printk("Error: Failed to bind to PWM0\n\r");
+    return -ENODEV;
+  } else {
+    printk("Bind to PWM0 successful\n\r");
+  }
+
+  return 0;
+}
+
+int stage_C_actuate(void)
+{
+  int ret = 0;
+  unsigned int mv;
+
+  ret = pwm_pin_set_usec(pwm0_dev, BOARDLED_PIN,
+      pwmPeriod_us, (unsigned int)((pwmPeriod_us * var_bc) / 1023), PWM_POLARITY_NORMAL);
+
+  if (ret) 
+  {
+    printk("Error %d: failed to set pulse width\n\r", ret);
+    return ret;
+  }
+
+  mv = fixed_raw_to_mv(var_bc);
+  printk("PWM -> %4u \n\r",(unsigned int)((pwmPeriod_us * mv) / 3000));
+  return 0;
+}
+
+#ifdef CONFIG_PIPELINE_RUN_TO_COMPLETION
+
+/* ###################    RUN TO COMPLETION    ######################*/
+
+static void pipeline_timer_handler(struct k_timer *timer)
+{
+  pipeline_release = stage_stats_now();
+  k_work_submit(&pipeline_work);
+}
+
+static void pipeline_work_handler(struct k_work *work)
+{
+  timing_t start_A, end_A, end_B, end_C;
+
+  start_A = stage_stats_now();
+  printk("Pipeline Activated\n\r");
+
+  /* Same stages as the threads, called one after the other in the work queue thread */
+  stage_A_sample();
+  end_A = stage_stats_now();
+  stage_B_filter();
+  end_B = stage_stats_now();
+  if (stage_C_actuate()) 
+  {
+    k_timer_stop(&pipeline_timer);
+  }
+  end_C = stage_stats_now();
+
+  /* Each stage is released when the previous one ends */
+  stage_stats_add(&stage_stats_A, pipeline_release, start_A, end_A);
+  stage_stats_add(&stage_stats_B, end_A, end_A, end_B);
+  stage_stats_add(&stage_stats_C, end_B, end_B, end_C);
+}
+
+#else
+
 /* ########################################################################################################################################## */
 /* ##################################                         THREAD IMPLEMENTATION                        ##################################*/
 /* ########################################################################################################################################## */
@@ -219,47 +353,38 @@ void main(void)
 
 void thread_A_code(void *argA , void *argB, void *argC)
 {
-  int err=0;
-  int count = 0;
-  int i;
   int64_t fin_time=0, release_time = 0;
-  int ret = 0;
+  timing_t release, start;
 
   printk("Thread A Init\n\r");
 
   release_time = k_uptime_get() + thread_A_period;
+  release = stage_stats_now();
 
   while(1)
   {
+    start = stage_stats_now();
     printk("Thread A Activated\n\r");
 
-    err = adc_sample();
-    if (err) 
-    {
-      printk("adc_sample() failed with error code %d\n\r", err);
-    } 
-    else 
-    {
-      if (adc_sample_buffer[0] > 1023) 
-      {
-        printk("adc reading out of range\n\r");
-      } 
-      else 
-      {
-        var_ab = adc_sample_buffer[0];
-        printk("adc reading  raw: %4u / %4u mV: \n\r", var_ab, (uint16_t)(1000 * var_ab * ((float)3 / 1023)));
-      }
-    }
+    stage_A_sample();
 
+    release_ab = stage_stats_now();
+    stage_stats_add(&stage_stats_A, release, start, release_ab);
     k_sem_give(&sem_ab);
 
+    /* Ready again at once, unless it sleeps until the next period */
+    release = stage_stats_now();
+#ifndef CONFIG_SAMPLER_BURST
     fin_time = k_uptime_get();
 
     if (fin_time < release_time) 
     {
       k_msleep(release_time - fin_time);
+      release = stage_stats_at_ms(release_time);
       release_time += thread_A_period;
     }
+#endif
+    /* In the burst mode the ADC paces the thread: sampler_read() waits for the next block */
   }
   timing_stop();
 }
@@ -268,9 +393,7 @@ void thread_A_code(void *argA , void *argB, void *argC)
 
 void thread_B_code(void *argA , void *argB, void *argC)
 {
-  int err=0;
-  uint16_t count = 0;
-  int i;
+  timing_t start;
 
   printk("Thread B Init\n\r");
 
@@ -278,46 +401,13 @@ void thread_B_code(void *argA , void *argB, void *argC)
   {
 
    k_sem_take(&sem_ab, K_FOREVER);
+   start = stage_stats_now();
    printk("Thread B Activated\n\r");
 
-   media = 0;
-   media_2 = 0;
-   count = 0;
-
-   for (i = 0; i < WINDOW_SIZE - 1; i++) 
-   {
-     buffer[i] = buffer[i + 1];
-     /*printk("adc reading %d: raw:%4u / %4u mV: \n\r", i, buffer[i], (uint16_t)(1000 * buffer[i] * ((float)3 / 1023))); */
-   }
-     buffer[WINDOW_SIZE - 1] = var_ab;
-     /*printk("adc reading %d: raw:%4u / %4u mV: \n\r", 9, buffer[9], (uint16_t)(1000 * buffer[9] * ((float)3 / 1023)));*/
-
-   for (i = 0; i < WINDOW_SIZE; i++) 
-   {
-     media = media + buffer[i];
-   }
-
-   media = media / WINDOW_SIZE;
-   desvio = 0.1 * media;
-
-   for (i = 0; i < WINDOW_SIZE; i++) 
-   {
-     if ((media + desvio > buffer[i]) && (media - desvio < buffer[i])) {
-       media_2 = media_2 + buffer[i];
-       count = count + 1;
-     }
-   }
-   if (count != 0) 
-   {
-     var_bc = media_2 / count;
-   } 
-   else 
-   {
-     var_bc = 0;
-   }
-
-   printk("adc reading %d: raw:%4u / %4u mV: \n\r", count, var_bc, (uint16_t)(1000 * var_bc * ((float)3 / 1023)));
+   stage_B_filter();
 
+   release_bc = stage_stats_now();
+   stage_stats_add(&stage_stats_B, release_ab, start, release_bc);
    k_sem_give(&sem_bc);
   }
 }
@@ -327,62 +417,31 @@ void thread_B_code(void *argA , void *argB, void *argC)
 
 void thread_C_code(void *argA , void *argB, void *argC)
 {
-  int i;
-  int ret = 0;
+  timing_t start;
 
   printk("Thread C Init\n\r");
 
-  const struct device *gpio0_dev;
-
-  gpio0_dev = device_get_binding(DT_LABEL(GPIO0_NID));
-
-  if (gpio0_dev == NULL) {
-    printk("Error: Failed to bind to GPIO0\n\r");
-    return;
-  } else {
-    printk("Bind to GPIO0 successfull \n\r");
-  }
-
-  ret = gpio_pin_configure(gpio0_dev, BOARDLED_PIN, GPIO_OUTPUT_ACTIVE);
-  if (ret < 0) {
-    printk("gpio_pin_configure() failed with error %d\n\r", ret);
-    return;
-  }
-
-  const struct device *pwm0_dev;
-
-  pwm0_dev = device_get_binding(DT_LABEL(PWM0_NID));
-
-  if (pwm0_dev == NULL) {
-    printk("Error: Failed to bind to PWM0\n r");
+  if (stage_C_init()) 
+  {
     return;
-  } else {
-    printk("Bind to PWM0 successful\n\r");
   }
 
-  unsigned int pwmPeriod_us = 250000;                       
-
   while(1)
   {
     k_sem_take(&sem_bc , K_FOREVER);
+    start = stage_stats_now();
 
     printk("Thread C Activated\n\r");
 
-    ret = 0;
-
-    ret = pwm_pin_set_usec(pwm0_dev, BOARDLED_PIN,
-        pwmPeriod_us, (unsigned int)((pwmPeriod_us * var_bc) / 1023), PWM_POLARITY_NORMAL);
-
-    if (ret) 
+    if (stage_C_actuate()) 
     {
-      printk("Error %d: failed to set pulse width\n", ret);
       return;
     }
-
-    var_bc = (uint16_t)(1000 * var_bc * ((float)3 / 1023));
-    printk("PWM -> %4u \n\r",(unsigned int)((pwmPeriod_us * var_bc) / 3000));
+    stage_stats_add(&stage_stats_C, release_bc, start, stage_stats_now());
   }
 }
+
+#endif
 /* ########################################################################################################################################## */
 /* ##################################                      THREAD IMPLEMENTATION FINITO                    ##################################*/
 /* ########################################################################################################################################## */
\ No newline at end of file
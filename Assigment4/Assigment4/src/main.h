@@ -48,9 +48,11 @@ void main(void);
  * @brief 
  * 
  * The thread A has the porpouse of reading the adc sampling and implement it in a semaphore.
- * \n Then it deals with the timing to read such samples.
+ * \n The reading is done by stage_A_sample(). Then it deals with the timing to read such samples.
  *  
  * @code
+ *  stage_A_sample();
+ *
  *  k_sem_give(&sem_ab);
  *
  *   fin_time = k_uptime_get();
@@ -66,33 +68,66 @@ void main(void);
  * 
  */
 void thread_A_code(void *argA , void *argB, void *argC);
+/* With CONFIG_STAGE_STATS every stage is timed (stage_stats.h): thread A is released by its period, threads B and C
+ * when the previous thread gives the semaphore (release_ab, release_bc). */
 
 /**
  * @brief 
- *  This thread deals with the information from the semphores and calculates the mean with samples that doesn't have too much deviation from the overall values.
+ *  This thread deals with the information from the semphores and filters it with stage_B_filter().
  *  \n The resulting value it's given to the next semaphore
  * 
- * \n Main code for the mean
+ */
+void thread_B_code(void *argA , void *argB, void *argC);
+
+/**
+ * @brief 
+ *  The thread C deals with the values for the PWM: it sets up the devices with stage_C_init() and then
+ *  calls stage_C_actuate() for every value of thread B.
+ * 
+ */
+void thread_C_code(void *argA , void *argB, void *argC);
+
+/**
+ * @brief 
+ *  Stage A: reads the ADC.
+ *  \n The samples come from sampler_read() (sampler.h); with CONFIG_SAMPLER_ASYNC the next
+ *  conversion is already running while the last one is handed over, so the stage does not wait for the ADC.
+ *  \n With CONFIG_SAMPLER_BURST it gets a block of samples taken by the driver at a fixed interval; the
+ *  pipeline then runs once per block instead of once per period.
+ *  \n The samples go to block_ab and block_ab_len, the last one to var_ab.
+ *
+ * @return 0 on success, negative error code otherwise (block_ab_len is then 0)
+ */
+int stage_A_sample(void);
+
+/**
+ * @brief 
+ *  Stage B: every sample of block_ab goes through the filter chain (filters.h), whose stages are
+ *  chosen in Kconfig. By default it is the original one: the mean of the window (CONFIG_FILTER_WINDOW_SIZE)
+ *  without the samples that have too much deviation from it. The output of the last sample goes to var_bc.
+ * 
+ * \n Main code of the filter
  * @code
- *for (i = 0; i < WINDOW_SIZE; i++) 
+ *  for (n = 0; n < block_ab_len; n++) 
  *  {
- *    if ((media + desvio > buffer[i]) && (media - desvio < buffer[i])) {
- *      media_2 = media_2 + buffer[i];
- *      count = count + 1;
- *    }
+ *    var_bc = filter_chain_step(&chain, block_ab[n]);
  *  }
- *  if (count != 0) 
- *  {
- *    var_bc = media_2 / count;
- *  }  
  * @endcode
  * 
  */
-void thread_B_code(void *argA , void *argB, void *argC);
+void stage_B_filter(void);
 
 /**
  * @brief 
- *  The thread C deals with the values for the PWM.
+ *  Binds to the GPIO and PWM devices used by stage_C_actuate().
+ *
+ * @return 0 on success, negative error code otherwise
+ */
+int stage_C_init(void);
+
+/**
+ * @brief 
+ *  Stage C: sets the PWM of the led from var_bc.
  *  \n Using the data from the mean done previously it is possible to see the output on the led of the board and on the screen.
  * 
  * @code
@@ -101,16 +136,17 @@ void thread_B_code(void *argA , void *argB, void *argC);
  *
  *   if (ret) 
  *   {
- *     printk("Error %d: failed to set pulse width\n", ret);
- *    return;
+ *     printk("Error %d: failed to set pulse width\n\r", ret);
+ *     return ret;
  *   }
  *
- *   var_bc = (uint16_t)(1000 * var_bc * ((float)3 / 1023));
- *   printk("PWM -> %4u \n\r",(unsigned int)((pwmPeriod_us * var_bc) / 3000));
+ *   mv = fixed_raw_to_mv(var_bc);
+ *   printk("PWM -> %4u \n\r",(unsigned int)((pwmPeriod_us * mv) / 3000));
  * @endcode
  * 
+ * @return 0 on success, negative error code otherwise
  */
-void thread_C_code(void *argA , void *argB, void *argC);
+int stage_C_actuate(void);
 
 
 
@@ -0,0 +1,193 @@
+/** @file sampler.c
+ * @brief ADC acquisition of the pipeline.
+ *
+ * The adc_sequence is built once; in the ping-pong modes only its buffer
+ * changes between the two halves. In the burst mode the sequence options
+ * make the driver take the samples of a block itself, paced by its timer.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <devicetree.h>
+#include <drivers/adc.h>
+#include <sys/printk.h>
+#include <hal/nrf_saadc.h>
+
+#include "sampler.h"
+
+#define ADC_NID DT_NODELABEL(adc)
+#define ADC_RESOLUTION 10
+#define ADC_GAIN ADC_GAIN_1_4
+#define ADC_REFERENCE ADC_REF_VDD_1_4
+#define ADC_ACQUISITION_TIME ADC_ACQ_TIME(ADC_ACQ_TIME_MICROSECONDS, 40)
+#define ADC_CHANNEL_ID 1
+
+#define ADC_CHANNEL_INPUT NRF_SAADC_INPUT_AIN1
+
+#ifdef CONFIG_SAMPLER_BURST
+#define BUFFER_SIZE CONFIG_SAMPLER_BURST_SAMPLES
+#else
+#define BUFFER_SIZE 1
+#endif
+
+/* ADC channel configuration */
+static const struct adc_channel_cfg my_channel_cfg = {
+    .gain = ADC_GAIN,
+    .reference = ADC_REFERENCE,
+    .acquisition_time = ADC_ACQUISITION_TIME,
+    .channel_id = ADC_CHANNEL_ID,
+    .input_positive = ADC_CHANNEL_INPUT
+};
+
+static const struct device *adc_dev = NULL;
+
+/* Two halves: the ADC writes one while the other is read (the poll mode uses only the first) */
+static uint16_t adc_sample_buffer[2][BUFFER_SIZE];
+
+#ifdef CONFIG_SAMPLER_BURST
+/* Called by the driver (interrupt context) after each sampling of a block */
+static enum adc_action burst_callback(const struct device *dev, const struct adc_sequence *seq,
+                                      uint16_t sampling_index)
+{
+    int16_t *block = seq->buffer;
+
+    /* The single ended input gives a few negative counts near 0 V, which
+     * would be read as out of range; the block keeps them as 0 */
+    if (block[sampling_index] < 0) {
+        block[sampling_index] = 0;
+    }
+    return ADC_ACTION_CONTINUE;
+}
+
+static const struct adc_sequence_options burst_options = {
+    .interval_us = CONFIG_SAMPLER_BURST_INTERVAL_US,
+    .callback = burst_callback,
+    .extra_samplings = BUFFER_SIZE - 1,
+};
+#endif
+
+static struct adc_sequence sequence = {
+#ifdef CONFIG_SAMPLER_BURST
+    .options = &burst_options,
+#endif
+    .channels = BIT(ADC_CHANNEL_ID),
+    .buffer = adc_sample_buffer[0],
+    .buffer_size = sizeof(adc_sample_buffer[0]),
+    .resolution = ADC_RESOLUTION,
+};
+
+#ifdef CONFIG_SAMPLER_PING_PONG
+static struct k_poll_signal adc_signal;
+static struct k_poll_event adc_event =
+    K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_SIGNAL, K_POLL_MODE_NOTIFY_ONLY, &adc_signal);
+
+static int armed = -1; /* Half being filled by the ADC, -1 if none */
+
+/* Starts the conversion into one half and returns without waiting */
+static int arm(int half)
+{
+    int ret;
+
+    k_poll_signal_reset(&adc_signal);
+    adc_event.state = K_POLL_STATE_NOT_READY;
+    sequence.buffer = adc_sample_buffer[half];
+
+    ret = adc_read_async(adc_dev, &sequence, &adc_signal);
+    armed = ret ? -1 : half;
+    return ret;
+}
+#endif
+
+int sampler_init(void)
+{
+    int err;
+
+    adc_dev = device_get_binding(DT_LABEL(ADC_NID));
+    if (!adc_dev) {
+        printk("ADC device_get_binding() failed\n\r");
+        return -ENODEV;
+    }
+
+    err = adc_channel_setup(adc_dev, &my_channel_cfg);
+    if (err) {
+        printk("adc_channel_setup() failed with error code %d\n\r", err);
+        return err;
+    }
+
+    NRF_SAADC->TASKS_CALIBRATEOFFSET = 1;
+
+#ifdef CONFIG_SAMPLER_PING_PONG
+    k_poll_signal_init(&adc_signal);
+#endif
+    return 0;
+}
+
+#ifdef CONFIG_SAMPLER_PING_PONG
+
+int sampler_read(const uint16_t **block)
+{
+    unsigned int signaled;
+    int result, ret, done;
+
+    if (adc_dev == NULL) {
+        printk("sampler_read(): error, must bind to adc first \n\r");
+        return -ENODEV;
+    }
+
+    /* First read, or the last start failed: nothing is being converted */
+    if (armed < 0) {
+        ret = arm(0);
+        if (ret) {
+            printk("adc_read_async() failed with code %d\n\r", ret);
+            return ret;
+        }
+    }
+
+    ret = k_poll(&adc_event, 1, K_FOREVER);
+    k_poll_signal_check(&adc_signal, &signaled, &result);
+    if (ret == 0 && !signaled) {
+        ret = -EIO;
+    } else if (ret == 0) {
+        ret = result;
+    }
+    done = armed;
+
+    /* The next sample goes to the other half while this one is used */
+    if (arm(done ^ 1)) {
+        printk("adc_read_async() failed\n\r");
+    }
+
+    if (ret) {
+        printk("adc conversion failed with code %d\n\r", ret);
+        return ret;
+    }
+
+    *block = adc_sample_buffer[done];
+    return BUFFER_SIZE;
+}
+
+#else
+
+int sampler_read(const uint16_t **block)
+{
+    int ret;
+
+    if (adc_dev == NULL) {
+        printk("sampler_read(): error, must bind to adc first \n\r");
+        return -ENODEV;
+    }
+
+    ret = adc_read(adc_dev, &sequence);
+    if (ret) {
+        printk("adc_read() failed with code %d\n\r", ret);
+        return ret;
+    }
+
+    *block = adc_sample_buffer[0];
+    return BUFFER_SIZE;
+}
+
+#endif
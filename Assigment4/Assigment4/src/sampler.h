@@ -0,0 +1,42 @@
+/** @file sampler.h
+ * @brief ADC acquisition of the pipeline.
+ *
+ * Reads the potentiometer on AIN1. The mode is chosen in Kconfig:
+ * - CONFIG_SAMPLER_POLL: adc_read(), the caller waits for the conversion.
+ * - CONFIG_SAMPLER_ASYNC: adc_read_async() with two buffers. While one
+ *   buffer is given to the caller the ADC fills the other one, so the
+ *   caller only waits if the conversion has not finished yet.
+ * - CONFIG_SAMPLER_BURST: like the async mode but each buffer is a block of
+ *   CONFIG_SAMPLER_BURST_SAMPLES samples taken by the driver every
+ *   CONFIG_SAMPLER_BURST_INTERVAL_US, so there is one wakeup per block.
+ *
+ * In the ping-pong modes a block stays valid until the next block is
+ * complete, the time the consumer has to use it.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _sampler_h
+#define _sampler_h
+
+#include <stdint.h>
+
+#define SAMPLER_MAX 1023 /* Largest raw value with 10 bits */
+
+/**
+ * @brief Binds to the ADC, sets up the channel and calibrates the offset.
+ * @return 0 on success, negative error code otherwise
+ */
+int sampler_init(void);
+
+/**
+ * @brief Gets the next samples.
+ *
+ * In the async and burst modes the next conversion is started before returning.
+ * @param block set to the samples, valid until the next call
+ * @return number of samples, negative error code on failure
+ */
+int sampler_read(const uint16_t **block);
+
+#endif
@@ -0,0 +1,181 @@
+/** @file stage_stats.c
+ * @brief Timing statistics of the three stages of the pipeline.
+ *
+ * Each stage writes only its own statistics, from its thread (or from the
+ * work item), and the shell reads them from the shell thread. A spinlock
+ * keeps the shell from copying a half updated stage; the printing is done
+ * on the copy.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <shell/shell.h>
+#include <string.h>
+
+#include "stage_stats.h"
+
+#define METRIC_INIT { .min = UINT32_MAX }
+
+struct stage_stats stage_stats_A = { .name = "A", .latency = METRIC_INIT, .exec = METRIC_INIT, .response = METRIC_INIT };
+struct stage_stats stage_stats_B = { .name = "B", .latency = METRIC_INIT, .exec = METRIC_INIT, .response = METRIC_INIT };
+struct stage_stats stage_stats_C = { .name = "C", .latency = METRIC_INIT, .exec = METRIC_INIT, .response = METRIC_INIT };
+
+static struct stage_stats *const stages[] = { &stage_stats_A, &stage_stats_B, &stage_stats_C };
+
+static const struct stage_metric empty = METRIC_INIT;
+
+static struct k_spinlock lock;
+
+void stage_stats_init(void)
+{
+    timing_init();
+    timing_start();
+}
+
+timing_t stage_stats_at_ms(int64_t uptime_ms)
+{
+    timing_t now = timing_counter_get();
+    int64_t late_ns = (int64_t)k_ticks_to_ns_floor64(k_uptime_ticks()) - uptime_ms * 1000000;
+
+    if (late_ns <= 0) {
+        return now;
+    }
+    return now - (uint64_t)late_ns * timing_freq_get() / 1000000000u;
+}
+
+static uint32_t cycles(timing_t *from, timing_t *to)
+{
+    uint64_t c = timing_cycles_get(from, to);
+
+    return (c > UINT32_MAX) ? UINT32_MAX : c;
+}
+
+static void metric_add(struct stage_metric *m, uint32_t c)
+{
+    uint32_t b = (c == 0) ? 0 : 32 - __builtin_clz(c);
+
+    m->bucket[b]++;
+    m->sum += c;
+    if (c < m->min) {
+        m->min = c;
+    }
+    if (c > m->max) {
+        m->max = c;
+    }
+}
+
+void stage_stats_add(struct stage_stats *s, timing_t release, timing_t start, timing_t end)
+{
+    uint32_t latency = cycles(&release, &start);
+    uint32_t exec = cycles(&start, &end);
+    uint32_t response = cycles(&release, &end);
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    metric_add(&s->latency, latency);
+    metric_add(&s->exec, exec);
+    metric_add(&s->response, response);
+    s->count++;
+    k_spin_unlock(&lock, key);
+}
+
+static void snapshot(const struct stage_stats *s, struct stage_stats *copy)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+
+    *copy = *s;
+    k_spin_unlock(&lock, key);
+}
+
+static uint32_t us(uint64_t c)
+{
+    return timing_cycles_to_ns(c) / 1000;
+}
+
+/* ###################    SHELL COMMANDS    ######################*/
+
+static int cmd_show(const struct shell *sh, size_t argc, char **argv)
+{
+    struct stage_stats s;
+    const struct stage_metric *m;
+    int i;
+
+    shell_print(sh, "Stage  count | latency min/mean/max | exec min/mean/max (WCET) | response min/mean/max | jitter (us)");
+    for (i = 0; i < ARRAY_SIZE(stages); i++) {
+        snapshot(stages[i], &s);
+        if (s.count == 0) {
+            shell_print(sh, "%-5s %6u |", s.name, 0);
+            continue;
+        }
+        m = &s.response;
+        shell_print(sh, "%-5s %6u | %6u %6u %6u | %6u %6u %6u | %6u %6u %6u | %6u", s.name, s.count,
+                    us(s.latency.min), us(s.latency.sum / s.count), us(s.latency.max),
+                    us(s.exec.min), us(s.exec.sum / s.count), us(s.exec.max),
+                    us(m->min), us(m->sum / s.count), us(m->max), us(m->max - m->min));
+    }
+    return 0;
+}
+
+static void print_hist(const struct shell *sh, const char *name, const struct stage_metric *m)
+{
+    uint64_t low, high;
+    int b;
+
+    shell_print(sh, "%s:", name);
+    for (b = 0; b < STAGE_STATS_BUCKETS; b++) {
+        if (m->bucket[b] == 0) {
+            continue;
+        }
+        low = (b == 0) ? 0 : BIT64(b - 1);
+        high = BIT64(b) - 1;
+        shell_print(sh, "  %10u .. %10u us : %u", us(low), us(high), m->bucket[b]);
+    }
+}
+
+static int cmd_hist(const struct shell *sh, size_t argc, char **argv)
+{
+    struct stage_stats s;
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(stages); i++) {
+        if (strcmp(argv[1], stages[i]->name) == 0) {
+            break;
+        }
+    }
+    if (i == ARRAY_SIZE(stages)) {
+        shell_error(sh, "Error %d: no stage %s, use A, B or C", -EINVAL, argv[1]);
+        return -EINVAL;
+    }
+
+    snapshot(stages[i], &s);
+    shell_print(sh, "Stage %s: %u activations (log2 buckets)", s.name, s.count);
+    print_hist(sh, "latency", &s.latency);
+    print_hist(sh, "exec", &s.exec);
+    print_hist(sh, "response", &s.response);
+    return 0;
+}
+
+static int cmd_reset(const struct shell *sh, size_t argc, char **argv)
+{
+    k_spinlock_key_t key = k_spin_lock(&lock);
+    int i;
+
+    for (i = 0; i < ARRAY_SIZE(stages); i++) {
+        stages[i]->count = 0;
+        stages[i]->latency = empty;
+        stages[i]->exec = empty;
+        stages[i]->response = empty;
+    }
+    k_spin_unlock(&lock, key);
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_stages,
+    SHELL_CMD(show, NULL, "Min, mean and max of every stage, in us", cmd_show),
+    SHELL_CMD_ARG(hist, NULL, "Histograms of one stage: hist <A|B|C>", cmd_hist, 2, 0),
+    SHELL_CMD(reset, NULL, "Clears the statistics", cmd_reset),
+    SHELL_SUBCMD_SET_END
+);
+
+SHELL_CMD_REGISTER(stages, &sub_stages, "Timing of the pipeline stages", NULL);
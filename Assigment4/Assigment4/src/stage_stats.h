@@ -0,0 +1,117 @@
+/** @file stage_stats.h
+ * @brief Timing statistics of the three stages of the pipeline.
+ *
+ * Every activation of a stage gives three timestamps of timing_counter_get():
+ * - release: when the stage had its work to do (the period of thread A, or
+ *   the moment the previous stage handed over the sample),
+ * - start: when the stage began to run,
+ * - end: when it finished.
+ *
+ * From them three metrics are kept per stage, each with min, max, mean and a
+ * histogram:
+ * - latency: release -> start,
+ * - execution: start -> end, so the max is the measured WCET,
+ * - response: release -> end; max - min is the jitter of the stage.
+ *
+ * The shell command "stages" prints them (stages show, stages hist <A|B|C>,
+ * stages reset).
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _stage_stats_h
+#define _stage_stats_h
+
+#include <zephyr.h>
+#include <timing/timing.h>
+
+#define STAGE_STATS_BUCKETS 33 /* Bucket b holds [2^(b-1), 2^b) cycles, bucket 0 holds 0 */
+
+/**
+ * @brief Min, max, sum and histogram of one metric, in cycles of the timing counter.
+ */
+struct stage_metric {
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t bucket[STAGE_STATS_BUCKETS];
+};
+
+/**
+ * @brief Metrics of one stage.
+ */
+struct stage_stats {
+    const char *name;             /**< Name shown by the shell */
+    uint32_t count;               /**< Activations measured */
+    struct stage_metric latency;  /**< Release -> start */
+    struct stage_metric exec;     /**< Start -> end */
+    struct stage_metric response; /**< Release -> end */
+};
+
+#ifdef CONFIG_STAGE_STATS
+
+/** @brief Stage A, sampling. */
+extern struct stage_stats stage_stats_A;
+
+/** @brief Stage B, filtering. */
+extern struct stage_stats stage_stats_B;
+
+/** @brief Stage C, PWM. */
+extern struct stage_stats stage_stats_C;
+
+/**
+ * @brief Starts the timing counter; call it before any other function.
+ */
+void stage_stats_init(void);
+
+/**
+ * @brief Reads the timing counter.
+ * @return timestamp for stage_stats_add()
+ */
+static inline timing_t stage_stats_now(void)
+{
+    return timing_counter_get();
+}
+
+/**
+ * @brief Converts a release time of the kernel clock to the timing counter.
+ *
+ * Only the time since the release is converted, so the drift between the
+ * two clocks does not pile up from period to period.
+ *
+ * @param uptime_ms release time, in ms of k_uptime_get(), not in the future
+ * @return timestamp for stage_stats_add()
+ */
+timing_t stage_stats_at_ms(int64_t uptime_ms);
+
+/**
+ * @brief Adds one activation of a stage.
+ * @param s stage
+ * @param release when the stage had its work to do
+ * @param start when it began to run
+ * @param end when it finished
+ */
+void stage_stats_add(struct stage_stats *s, timing_t release, timing_t start, timing_t end);
+
+#else
+
+static inline void stage_stats_init(void)
+{
+}
+
+static inline timing_t stage_stats_now(void)
+{
+    return 0;
+}
+
+static inline timing_t stage_stats_at_ms(int64_t uptime_ms)
+{
+    return 0;
+}
+
+#define stage_stats_add(s, release, start, end) ((void)(release), (void)(start), (void)(end))
+
+#endif
+
+#endif
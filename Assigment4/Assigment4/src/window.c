@@ -0,0 +1,79 @@
+/** @file window.c
+ * @brief Sliding window of thread B.
+ *
+ * Position i of the trees (1 to WINDOW_VALUES) is the raw value i - 1.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <string.h>
+
+#include "window.h"
+
+/* Adds count samples (negative to remove) of one value to the trees */
+static void tree_update(struct window *w, uint16_t value, int32_t count)
+{
+    uint32_t i;
+
+    for (i = value + 1; i <= WINDOW_VALUES; i += i & -i) {
+        w->count_tree[i] += count;
+        w->sum_tree[i] += count * (int32_t)value;
+    }
+}
+
+/* Samples with a value up to the given one */
+static uint32_t tree_prefix(const struct window *w, int32_t value, uint32_t *sum)
+{
+    uint32_t i, count = 0;
+
+    *sum = 0;
+    if (value < 0) {
+        return 0;
+    }
+    if (value >= WINDOW_VALUES) {
+        value = WINDOW_VALUES - 1;
+    }
+    for (i = value + 1; i > 0; i -= i & -i) {
+        count += w->count_tree[i];
+        *sum += w->sum_tree[i];
+    }
+    return count;
+}
+
+void window_init(struct window *w)
+{
+    memset(w, 0, sizeof(*w));
+    tree_update(w, 0, WINDOW_SIZE);
+}
+
+void window_add(struct window *w, uint16_t sample)
+{
+    uint16_t old = w->ring[w->head];
+
+    if (sample >= WINDOW_VALUES) {
+        sample = WINDOW_VALUES - 1;
+    }
+
+    w->ring[w->head] = sample;
+    w->head = (w->head + 1 == WINDOW_SIZE) ? 0 : w->head + 1;
+    w->sum += sample - old;
+
+    if (sample != old) {
+        tree_update(w, old, -1);
+        tree_update(w, sample, 1);
+    }
+}
+
+uint32_t window_range(const struct window *w, int32_t low, int32_t high, uint32_t *sum)
+{
+    uint32_t count, below_sum;
+
+    if (low > high) {
+        *sum = 0;
+        return 0;
+    }
+    count = tree_prefix(w, high, sum) - tree_prefix(w, low - 1, &below_sum);
+    *sum -= below_sum;
+    return count;
+}
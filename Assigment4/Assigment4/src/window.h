@@ -0,0 +1,68 @@
+/** @file window.h
+ * @brief Sliding window of thread B.
+ *
+ * The last WINDOW_SIZE samples are kept in a ring, so adding one only
+ * replaces the oldest. Besides the running sum, the window keeps how many
+ * samples have each raw value, and their sum, in two Fenwick trees over
+ * the WINDOW_VALUES possible values. Counting (and adding) the samples
+ * inside a range of values is then two prefix queries.
+ * \n Adding a sample and every query take O(log WINDOW_VALUES) steps (10),
+ * whatever the size of the window.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _window_h
+#define _window_h
+
+#include <stdint.h>
+
+#define WINDOW_SIZE CONFIG_FILTER_WINDOW_SIZE /* Samples in the window */
+#define WINDOW_VALUES 1024                    /* Raw values, 10 bits */
+
+/**
+ * @brief Window of samples.
+ */
+struct window {
+    uint16_t ring[WINDOW_SIZE];          /**< Samples, the oldest at head */
+    uint32_t head;                       /**< Next position to replace */
+    uint32_t sum;                        /**< Sum of the samples */
+    uint16_t count_tree[WINDOW_VALUES + 1]; /**< Fenwick tree of the samples per value */
+    uint32_t sum_tree[WINDOW_VALUES + 1];   /**< Fenwick tree of their sum per value */
+};
+
+/**
+ * @brief Fills the window with zeros, like the first samples before any reading.
+ * @param w window
+ */
+void window_init(struct window *w);
+
+/**
+ * @brief Adds a sample in place of the oldest one.
+ * @param w window
+ * @param sample raw value, values above WINDOW_VALUES - 1 are taken as the largest one
+ */
+void window_add(struct window *w, uint16_t sample);
+
+/**
+ * @brief Mean of all the samples.
+ * @param w window
+ * @return the mean, rounded down
+ */
+static inline uint16_t window_mean(const struct window *w)
+{
+    return w->sum / WINDOW_SIZE;
+}
+
+/**
+ * @brief Samples with a value from low to high, both included.
+ * @param w window
+ * @param low smallest value, may be negative
+ * @param high largest value, may be above the raw range
+ * @param sum set to the sum of those samples
+ * @return number of samples in the range
+ */
+uint32_t window_range(const struct window *w, int32_t low, int32_t high, uint32_t *sum);
+
+#endif
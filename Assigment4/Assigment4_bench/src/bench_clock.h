@@ -0,0 +1,58 @@
+/** @file bench_clock.h
+ * @brief Clock of the benchmarks.
+ *
+ * On native_posix the simulated time does not move while code runs, so
+ * the host clock is used. On the boards (and qemu) it is the cycle counter
+ * of the timing functions.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _bench_clock_h
+#define _bench_clock_h
+
+#include <zephyr.h>
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include <time.h>
+#else
+#include <timing/timing.h>
+#endif
+
+/**
+ * @brief Starts the clock, once before the first bench_now_ns().
+ */
+static inline void bench_clock_init(void)
+{
+#ifndef CONFIG_BOARD_NATIVE_POSIX
+    timing_init();
+    timing_start();
+#endif
+}
+
+/**
+ * @brief Time since an arbitrary origin.
+ * @return time in ns
+ */
+static inline uint64_t bench_now_ns(void)
+{
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#else
+    static timing_t origin;
+    static bool started = false;
+    timing_t now = timing_counter_get();
+
+    if (!started) {
+        origin = now;
+        started = true;
+    }
+    return timing_cycles_to_ns(timing_cycles_get(&origin, &now));
+#endif
+}
+
+#endif
@@ -0,0 +1,403 @@
+/** @file ipc_bench.c
+ * @brief Benchmark of the hand-off between the threads of the pipeline.
+ *
+ * Each hand-off is a pair of functions, send and receive, for the two hops
+ * (0: A -> B, 1: B -> C). Both copy a struct bench_msg, so every hand-off
+ * moves the same data.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/atomic.h>
+#include <sys/printk.h>
+#include <string.h>
+
+#include "bench_clock.h"
+#include "fixed.h"
+#include "ipc_bench.h"
+
+#define STACK_SIZE 1024
+#define STAGE_PRIO 1
+
+#define HOPS 2
+
+struct bench_msg {
+    void *fifo_reserved; /* 1st word reserved for use by FIFO */
+    uint32_t seq;
+    uint16_t data;
+    uint64_t sent_ns;    /* When the message was sent */
+};
+
+struct ipc_ops {
+    const char *name;
+    void (*init)(void);
+    void (*send)(int hop, const struct bench_msg *msg);
+    void (*recv)(int hop, struct bench_msg *msg);
+};
+
+struct hop_stats {
+    uint64_t sum_ns;
+    uint32_t max_ns;
+};
+
+K_THREAD_STACK_DEFINE(stage_A_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(stage_B_stack, STACK_SIZE);
+K_THREAD_STACK_DEFINE(stage_C_stack, STACK_SIZE);
+
+static struct k_thread stage_A_data;
+static struct k_thread stage_B_data;
+static struct k_thread stage_C_data;
+
+static const struct ipc_ops *ops; /* Hand-off of the current run */
+static uint32_t run_samples;
+static bool run_wait;             /* A waits for C after each sample */
+
+static K_SEM_DEFINE(sample_done, 0, 1);
+
+static struct hop_stats hop[HOPS];
+static uint32_t out_of_order;
+static volatile uint16_t output; /* The "PWM" of stage C */
+
+/* ######################## Semaphores and globals ######################## */
+
+static struct bench_msg var_msg[HOPS];
+static struct k_sem sem_full[HOPS];
+static struct k_sem sem_empty[HOPS];
+
+static void sem_init(void)
+{
+    int i;
+
+    for (i = 0; i < HOPS; i++) {
+        k_sem_init(&sem_full[i], 0, 1);
+        k_sem_init(&sem_empty[i], 1, 1);
+    }
+}
+
+static void sem_send(int h, const struct bench_msg *msg)
+{
+    k_sem_take(&sem_empty[h], K_FOREVER);
+    var_msg[h] = *msg;
+    k_sem_give(&sem_full[h]);
+}
+
+static void sem_recv(int h, struct bench_msg *msg)
+{
+    k_sem_take(&sem_full[h], K_FOREVER);
+    *msg = var_msg[h];
+    k_sem_give(&sem_empty[h]);
+}
+
+/* ########################### k_fifo + k_mem_slab ########################### */
+
+/* The block goes from A to C: A allocates it, B forwards the one it received and C frees it.
+ * Only A waits for the pool, and C, which frees, never allocates, so the stages cannot block each other */
+K_MEM_SLAB_DEFINE(msg_slab, sizeof(struct bench_msg), HOPS * IPC_QUEUE_SIZE, 8);
+static struct k_fifo fifo[HOPS];
+static struct bench_msg *held; /* Block received by B, owned by B until it is sent to C */
+
+static void fifo_init(void)
+{
+    int i;
+
+    for (i = 0; i < HOPS; i++) {
+        k_fifo_init(&fifo[i]);
+    }
+    held = NULL;
+}
+
+static void fifo_send(int h, const struct bench_msg *msg)
+{
+    struct bench_msg *m;
+
+    if (h == 0) {
+        /* Waits for a free message when the pool is empty (the consumers are behind) */
+        k_mem_slab_alloc(&msg_slab, (void **)&m, K_FOREVER);
+    } else {
+        m = held;
+        held = NULL;
+    }
+    *m = *msg;
+    k_fifo_put(&fifo[h], m); /* The next stage owns the message now */
+}
+
+static void fifo_recv(int h, struct bench_msg *msg)
+{
+    struct bench_msg *m = k_fifo_get(&fifo[h], K_FOREVER);
+
+    *msg = *m;
+    if (h == 0) {
+        held = m;
+    } else {
+        k_mem_slab_free(&msg_slab, (void **)&m);
+    }
+}
+
+/* ################################# k_msgq ################################# */
+
+K_MSGQ_DEFINE(msgq_ab, sizeof(struct bench_msg), IPC_QUEUE_SIZE, 8);
+K_MSGQ_DEFINE(msgq_bc, sizeof(struct bench_msg), IPC_QUEUE_SIZE, 8);
+static struct k_msgq *const msgq[HOPS] = { &msgq_ab, &msgq_bc };
+
+static void msgq_init(void)
+{
+    int i;
+
+    for (i = 0; i < HOPS; i++) {
+        k_msgq_purge(msgq[i]);
+    }
+}
+
+static void msgq_send(int h, const struct bench_msg *msg)
+{
+    k_msgq_put(msgq[h], msg, K_FOREVER);
+}
+
+static void msgq_recv(int h, struct bench_msg *msg)
+{
+    k_msgq_get(msgq[h], msg, K_FOREVER);
+}
+
+/* ################################# k_pipe ################################# */
+
+K_PIPE_DEFINE(pipe_ab, IPC_QUEUE_SIZE * sizeof(struct bench_msg), 8);
+K_PIPE_DEFINE(pipe_bc, IPC_QUEUE_SIZE * sizeof(struct bench_msg), 8);
+static struct k_pipe *const pipe[HOPS] = { &pipe_ab, &pipe_bc };
+
+static void pipe_init(void)
+{
+    /* The pipes are empty after every run, each message sent is read */
+}
+
+static void pipe_send(int h, const struct bench_msg *msg)
+{
+    size_t written;
+
+    k_pipe_put(pipe[h], (void *)msg, sizeof(*msg), &written, sizeof(*msg), K_FOREVER);
+}
+
+static void pipe_recv(int h, struct bench_msg *msg)
+{
+    size_t read;
+
+    k_pipe_get(pipe[h], msg, sizeof(*msg), &read, sizeof(*msg), K_FOREVER);
+}
+
+/* ############################# Lock-free ring ############################# */
+
+/* One producer and one consumer per ring: head is written only by the producer,
+ * tail only by the consumer, so no lock is needed */
+struct ring {
+    struct bench_msg slot[IPC_QUEUE_SIZE];
+    atomic_t head; /* Next slot to write */
+    atomic_t tail; /* Next slot to read */
+};
+
+static struct ring ring[HOPS];
+
+static void ring_init(void)
+{
+    memset(ring, 0, sizeof(ring));
+}
+
+static void ring_send(int h, const struct bench_msg *msg)
+{
+    struct ring *r = &ring[h];
+    atomic_val_t head = atomic_get(&r->head);
+
+    while (head - atomic_get(&r->tail) == IPC_QUEUE_SIZE) {
+        k_yield(); /* Full: let the consumer run */
+    }
+    r->slot[head % IPC_QUEUE_SIZE] = *msg;
+    atomic_set(&r->head, head + 1); /* Publishes the slot */
+}
+
+static void ring_recv(int h, struct bench_msg *msg)
+{
+    struct ring *r = &ring[h];
+    atomic_val_t tail = atomic_get(&r->tail);
+
+    while (atomic_get(&r->head) == tail) {
+        k_yield(); /* Empty: let the producer run */
+    }
+    *msg = r->slot[tail % IPC_QUEUE_SIZE];
+    atomic_set(&r->tail, tail + 1); /* Frees the slot */
+}
+
+static const struct ipc_ops all_ops[] = {
+    { "sem + globals", sem_init, sem_send, sem_recv },
+    { "k_fifo + k_mem_slab", fifo_init, fifo_send, fifo_recv },
+    { "k_msgq", msgq_init, msgq_send, msgq_recv },
+    { "k_pipe", pipe_init, pipe_send, pipe_recv },
+    { "lock-free ring", ring_init, ring_send, ring_recv },
+};
+
+/* ################################# Stages ################################# */
+
+static void stage_A(void *argA, void *argB, void *argC)
+{
+    struct bench_msg msg = { 0 };
+    uint32_t seq;
+
+    for (seq = 0; seq < run_samples; seq++) {
+        msg.seq = seq;
+        msg.data = seq % 1024; /* Stands for the ADC */
+        msg.sent_ns = bench_now_ns();
+        ops->send(0, &msg);
+
+        if (run_wait) {
+            k_sem_take(&sample_done, K_FOREVER);
+        }
+    }
+}
+
+static void hop_done(int h, const struct bench_msg *msg)
+{
+    uint32_t ns = bench_now_ns() - msg->sent_ns;
+
+    hop[h].sum_ns += ns;
+    hop[h].max_ns = MAX(hop[h].max_ns, ns);
+}
+
+/* Work of stage B, once it has the sample */
+static void filter(struct bench_msg *msg)
+{
+    hop_done(0, msg);
+    msg->data -= fixed_tenth(msg->data); /* Stands for the filter */
+    msg->sent_ns = bench_now_ns();
+}
+
+/* Work of stage C, once it has the sample */
+static void actuate(const struct bench_msg *msg, uint32_t i)
+{
+    hop_done(1, msg);
+    if (msg->seq != i) {
+        out_of_order++;
+    }
+    output = msg->data;
+}
+
+static void stage_B(void *argA, void *argB, void *argC)
+{
+    struct bench_msg msg;
+    uint32_t i;
+
+    for (i = 0; i < run_samples; i++) {
+        ops->recv(0, &msg);
+        filter(&msg);
+        ops->send(1, &msg);
+    }
+}
+
+static void stage_C(void *argA, void *argB, void *argC)
+{
+    struct bench_msg msg;
+    uint32_t i;
+
+    for (i = 0; i < run_samples; i++) {
+        ops->recv(1, &msg);
+        actuate(&msg, i);
+
+        if (run_wait) {
+            k_sem_give(&sample_done);
+        }
+    }
+}
+
+/* Run to completion (CONFIG_PIPELINE_RUN_TO_COMPLETION): one context calls the three stages */
+static void stage_direct(void *argA, void *argB, void *argC)
+{
+    struct bench_msg msg = { 0 };
+    uint32_t seq;
+
+    for (seq = 0; seq < run_samples; seq++) {
+        msg.seq = seq;
+        msg.data = seq % 1024;
+        msg.sent_ns = bench_now_ns();
+        filter(&msg);
+        actuate(&msg, seq);
+    }
+}
+
+/* Runs the three stages to the end, returns the time it took; with no ops, the stages are direct calls */
+static uint64_t run(const struct ipc_ops *o, uint32_t samples, bool wait)
+{
+    uint64_t start;
+
+    ops = o;
+    run_samples = samples;
+    run_wait = wait;
+    memset(hop, 0, sizeof(hop));
+    k_sem_reset(&sample_done);
+
+    start = bench_now_ns();
+
+    if (ops == NULL) {
+        k_thread_create(&stage_A_data, stage_A_stack, K_THREAD_STACK_SIZEOF(stage_A_stack),
+                        stage_direct, NULL, NULL, NULL, K_PRIO_PREEMPT(STAGE_PRIO), 0, K_NO_WAIT);
+        k_thread_join(&stage_A_data, K_FOREVER);
+        return bench_now_ns() - start;
+    }
+
+    ops->init();
+
+    k_thread_create(&stage_C_data, stage_C_stack, K_THREAD_STACK_SIZEOF(stage_C_stack), stage_C,
+                    NULL, NULL, NULL, K_PRIO_PREEMPT(STAGE_PRIO), 0, K_NO_WAIT);
+    k_thread_create(&stage_B_data, stage_B_stack, K_THREAD_STACK_SIZEOF(stage_B_stack), stage_B,
+                    NULL, NULL, NULL, K_PRIO_PREEMPT(STAGE_PRIO), 0, K_NO_WAIT);
+    k_thread_create(&stage_A_data, stage_A_stack, K_THREAD_STACK_SIZEOF(stage_A_stack), stage_A,
+                    NULL, NULL, NULL, K_PRIO_PREEMPT(STAGE_PRIO), 0, K_NO_WAIT);
+
+    k_thread_join(&stage_A_data, K_FOREVER);
+    k_thread_join(&stage_B_data, K_FOREVER);
+    k_thread_join(&stage_C_data, K_FOREVER);
+
+    return bench_now_ns() - start;
+}
+
+static void print_run(const char *name, const struct ipc_ops *o)
+{
+    uint64_t ns;
+    uint32_t rate;
+
+    run(o, IPC_LATENCY_SAMPLES, true);
+    printk("%-20s %7u ns %7u ns %7u ns %7u ns", name,
+           (uint32_t)(hop[0].sum_ns / IPC_LATENCY_SAMPLES), hop[0].max_ns,
+           (uint32_t)(hop[1].sum_ns / IPC_LATENCY_SAMPLES), hop[1].max_ns);
+
+    ns = run(o, IPC_RATE_SAMPLES, false);
+    rate = (ns > 0) ? (uint64_t)IPC_RATE_SAMPLES * 1000000000u / ns : 0;
+    printk(" %12u\n\r", rate);
+}
+
+int ipc_bench(void)
+{
+    uint32_t errors = 0;
+    int i;
+
+    printk("\n\r--- Hand-off between the stages: latency over %u samples, rate over %u ---\n\r",
+           IPC_LATENCY_SAMPLES, IPC_RATE_SAMPLES);
+    printk("%-20s %10s %10s %10s %10s %12s\n\r", "", "A->B mean", "A->B max", "B->C mean",
+           "B->C max", "samples/s");
+
+    for (i = 0; i <= ARRAY_SIZE(all_ops); i++) {
+        out_of_order = 0;
+
+        /* The last line is the run to completion mode, with no hand-off */
+        if (i < ARRAY_SIZE(all_ops)) {
+            print_run(all_ops[i].name, &all_ops[i]);
+        } else {
+            print_run("direct calls", NULL);
+        }
+
+        if (out_of_order) {
+            printk("Error: %u samples out of order\n\r", out_of_order);
+            errors += out_of_order;
+        }
+    }
+    printk("%-20s not in this Zephyr version\n\r", "zbus");
+
+    return errors ? -1 : 0;
+}
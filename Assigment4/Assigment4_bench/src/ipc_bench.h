@@ -0,0 +1,44 @@
+/** @file ipc_bench.h
+ * @brief Benchmark of the hand-off between the threads of the pipeline.
+ *
+ * The three stages of the pipeline (A produces a sample, B filters it,
+ * C uses it) run as three threads of the same priority, like in the
+ * application, and pass the samples with each of:
+ * - a semaphore pair and a global variable, as in Assigment4 (with a
+ *   second semaphore so A waits for a free slot instead of overwriting it),
+ * - k_fifo, with the messages from a k_mem_slab pool (Assigment4_fifo),
+ * - k_msgq,
+ * - k_pipe,
+ * - a lock-free single producer / single consumer ring, where the threads
+ *   poll and k_yield() instead of blocking.
+ *
+ * The last line is the run to completion mode of Assigment4
+ * (CONFIG_PIPELINE_RUN_TO_COMPLETION): one thread calls the three stages,
+ * nothing is handed over and there are no context switches.
+ * \n zbus does not exist in this Zephyr version (2.7).
+ * \n For each one:
+ * - latency: A sends one sample and waits for C to get it, IPC_LATENCY_SAMPLES
+ *   times. The time from the send to the receive is kept for A -> B and B -> C.
+ * - rate: A sends IPC_RATE_SAMPLES samples as fast as the hand-off lets it.
+ *   The rate is the number of samples over the time until C got the last one.
+ *
+ * The stages do almost no work, so the numbers are the cost of the hand-off.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _ipc_bench_h
+#define _ipc_bench_h
+
+#define IPC_LATENCY_SAMPLES 1000
+#define IPC_RATE_SAMPLES 10000
+#define IPC_QUEUE_SIZE 8 /* Messages each queue can hold */
+
+/**
+ * @brief Runs the pipeline over every hand-off and prints latencies and rates.
+ * @return 0 if every sample arrived, in order, -1 otherwise
+ */
+int ipc_bench(void);
+
+#endif
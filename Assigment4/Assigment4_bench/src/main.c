@@ -0,0 +1,39 @@
+/** @file main.c
+ * @brief Benchmarks of the pipeline of Assigment 4.
+ *
+ * Runs every benchmark once and prints the results on the console. On
+ * native_posix the program exits at the end.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+#include <posix_board_if.h>
+#endif
+
+#include "bench_clock.h"
+#include "ipc_bench.h"
+#include "stats_bench.h"
+
+void main(void)
+{
+    int err = 0;
+
+    bench_clock_init();
+
+    if (stats_bench() != 0) {
+        err = 1;
+    }
+    if (ipc_bench() != 0) {
+        err = 1;
+    }
+
+    printk("\n\rBenchmarks %s\n\r", err ? "failed" : "done");
+#ifdef CONFIG_BOARD_NATIVE_POSIX
+    posix_exit(err);
+#endif
+}
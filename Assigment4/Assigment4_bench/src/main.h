@@ -0,0 +1,24 @@
+/** @file main.h
+ * @brief header support file
+ *
+ * This file consists on the header for the main file of the benchmarks.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _main_h
+#define _main_h
+
+/**
+ * @brief
+ *
+ * Starts the clock of the benchmarks and runs them one after the other:
+ * - stats_bench(): mean and variance of a block, old loops against CMSIS-DSP.
+ * - ipc_bench(): latency and rate of the pipeline over each way of passing the samples between threads.
+ *
+ * \n On native_posix it exits with 0 if every result was right, 1 otherwise.
+ */
+void main(void);
+
+#endif
@@ -0,0 +1,100 @@
+/** @file stats_bench.c
+ * @brief Benchmark of the block statistics.
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <sys/printk.h>
+
+#include "bench_clock.h"
+#include "block_stats.h"
+#include "stats_bench.h"
+
+static uint16_t block[BENCH_BLOCK];
+static volatile uint16_t window[BENCH_BLOCK]; /* Same samples, read like the old window */
+
+/* The old way: two passes over volatile data, one access at a time */
+static void volatile_stats(uint32_t n, struct block_stats *stats)
+{
+    uint64_t power = 0;
+    uint32_t sum = 0, i;
+    int32_t d;
+
+    for (i = 0; i < n; i++) {
+        sum += window[i];
+    }
+    stats->mean = sum / n;
+
+    for (i = 0; i < n; i++) {
+        d = (int32_t)window[i] - stats->mean;
+        power += d * d;
+    }
+    stats->variance = power / (n - 1);
+}
+
+/* Potentiometer around mid scale with +-32 counts of noise */
+static void fill_block(void)
+{
+    uint32_t seed = 12345, i;
+
+    for (i = 0; i < BENCH_BLOCK; i++) {
+        seed = seed * 1103515245u + 12345u;
+        block[i] = 512 - 32 + (seed >> 16) % 65;
+        window[i] = block[i];
+    }
+}
+
+static void print_result(const char *name, uint64_t ns, const struct block_stats *stats)
+{
+    uint32_t samples = BENCH_ROUNDS * BENCH_BLOCK;
+
+    printk("%-22s %6u ns/block %4u.%02u ns/sample  mean %u variance %u\n\r", name,
+           (uint32_t)(ns / BENCH_ROUNDS), (uint32_t)(ns / samples),
+           (uint32_t)(ns * 100 / samples % 100), stats->mean, stats->variance);
+}
+
+int stats_bench(void)
+{
+    struct block_stats old, scalar, dsp;
+    uint64_t start, old_ns, scalar_ns, dsp_ns;
+    int round;
+
+    fill_block();
+
+    start = bench_now_ns();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        volatile_stats(BENCH_BLOCK, &old);
+    }
+    old_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        block_stats_scalar(block, BENCH_BLOCK, &scalar);
+    }
+    scalar_ns = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (round = 0; round < BENCH_ROUNDS; round++) {
+        block_stats(block, BENCH_BLOCK, &dsp);
+    }
+    dsp_ns = bench_now_ns() - start;
+
+    printk("\n\r--- Block statistics: %u samples per block, %u blocks ---\n\r", BENCH_BLOCK,
+           BENCH_ROUNDS);
+    print_result("volatile loops", old_ns, &old);
+    print_result("plain loops", scalar_ns, &scalar);
+#ifdef CONFIG_BLOCK_STATS_CMSIS
+    print_result("CMSIS-DSP", dsp_ns, &dsp);
+#else
+    print_result("CMSIS-DSP (not built)", dsp_ns, &dsp);
+#endif
+
+    if (old.mean != scalar.mean || old.variance != scalar.variance ||
+        dsp.mean != scalar.mean || dsp.variance != scalar.variance) {
+        printk("Error: the versions do not agree\n\r");
+        return -1;
+    }
+    return 0;
+}
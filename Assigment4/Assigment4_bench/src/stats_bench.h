@@ -0,0 +1,26 @@
+/** @file stats_bench.h
+ * @brief Benchmark of the block statistics.
+ *
+ * Mean and variance of a block of BENCH_BLOCK samples, computed:
+ * - by C loops over a volatile buffer, the way thread B used to go over
+ *   its window,
+ * - by block_stats_scalar(), the same loops over a plain buffer,
+ * - by block_stats(), CMSIS-DSP when it is built (CONFIG_BLOCK_STATS_CMSIS).
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _stats_bench_h
+#define _stats_bench_h
+
+#define BENCH_BLOCK 1024 /* Samples per block */
+#define BENCH_ROUNDS 100 /* Blocks timed for each version */
+
+/**
+ * @brief Runs the three versions, checks that they agree and prints the time per sample.
+ * @return 0 if the results agree, -1 otherwise
+ */
+int stats_bench(void);
+
+#endif
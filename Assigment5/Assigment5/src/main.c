@@ -53,6 +53,8 @@
 #include <stdlib.h>
 #include <console/console.h>
 
+#include "buttons.h"
+
 
 /* ########################################################################################################################################## */
 /* ##################################                            ADC DEFINITIONS                           ##################################*/
@@ -177,55 +179,35 @@ struct k_sem sem_cd;
 /* ###################################                         BUTTON VARIABLES                           ###################################*/
 /* ########################################################################################################################################## */
 
-#define BOARDBUT1 0xb /* Pin at which BUT1 is connected. Addressing is direct (i.e., pin number) */
-#define BOARDBUT2 0xc
-#define BOARDBUT3 0x18
-#define BOARDBUT4 0x19
-
-static struct gpio_callback but1_cb_data; /* Callback structure */
-static struct gpio_callback but2_cb_data; /* Callback structure */
-static struct gpio_callback but3_cb_data; /* Callback structure */
-static struct gpio_callback but4_cb_data; /* Callback structure */
+/* The 4 buttons of the board (aliases sw0..sw3 of the board devicetree) */
+static const struct button_map button_table[] = {
+    { GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios), 0 },
+    { GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios), 1 },
+    { GPIO_DT_SPEC_GET(DT_ALIAS(sw2), gpios), 2 },
+    { GPIO_DT_SPEC_GET(DT_ALIAS(sw3), gpios), 3 },
+};
 
 volatile int dcToggleFlag1 = 0; /* Flag to signal a BUT1 press */
 volatile int dcToggleFlag2 = 0; /* Flag to signal a BUT1 press */
 volatile int dcToggleFlag3 = 0; /* Flag to signal a BUT1 press */
 volatile int dcToggleFlag4 = 0; /* Flag to signal a BUT1 press */
 
-void but1press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit
-    printk("But1 pressed at %d\n\r", k_cycle_get_32()); */
-    
-    /* Update Flag*/
-    dcToggleFlag1 = 1;
-}
+/* Flag of each button, indexed by the event of the button */
+static volatile int *const button_flags[] = {
+    &dcToggleFlag1, &dcToggleFlag2, &dcToggleFlag3, &dcToggleFlag4
+};
 
-void but2press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+void buttonPressed(uint8_t event, enum button_action action, timing_t edge)
 {    
-    /* Inform that button was hit
-    printk("But2 pressed at %d\n\r", k_cycle_get_32()); */
-    
-    /* Update Flag*/
-    dcToggleFlag2 = 1;
-}
+    ARG_UNUSED(edge);
 
-void but3press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit
-    printk("But3 pressed at %d\n\r", k_cycle_get_32());*/
-    
-    /* Update Flag*/
-    dcToggleFlag3 = 1;
-}
+    /* Only the debounced press sets the flag */
+    if (action != BUTTON_PRESS) {
+        return;
+    }
 
-void but4press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
-{    
-    /* Inform that button was hit
-    printk("But4 pressed at %d\n\r", k_cycle_get_32());*/
-    
     /* Update Flag*/
-    dcToggleFlag4 = 1;
+    *button_flags[event] = 1;
 }
 
 /* ########################################################################################################################################## */
@@ -678,41 +660,11 @@ void clock(){
 
 void CONFIG_BUTTONS()
 {
-    int ret = 0;
-
-    const struct device *gpio0_dev;
-    gpio0_dev = device_get_binding(DT_LABEL(GPIO0_NID));
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT1, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT2, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT3, GPIO_INPUT | GPIO_PULL_UP);
-    ret = gpio_pin_configure(gpio0_dev, BOARDBUT4, GPIO_INPUT | GPIO_PULL_UP);
-
-    if (ret < 0) {
-        printk("Error %d: Failed to configure BUT 1 \n\r", ret);
-	return;
-    }
-
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT1, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT2, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT3, GPIO_INT_EDGE_TO_ACTIVE);
-    ret = gpio_pin_interrupt_configure(gpio0_dev, BOARDBUT4, GPIO_INT_EDGE_TO_ACTIVE);
+    int ret = buttons_init(button_table, ARRAY_SIZE(button_table), buttonPressed);
 
     if (ret != 0) {
-	printk("Error %d: failed to configure interrupt on BUT1 pin \n\r", ret);
-	return;
+        printk("Error %d: Failed to configure the buttons \n\r", ret);
     }
-
-    gpio_init_callback(&but1_cb_data, but1press_cbfunction, BIT(BOARDBUT1));
-    gpio_add_callback(gpio0_dev, &but1_cb_data);
-
-    gpio_init_callback(&but2_cb_data, but2press_cbfunction, BIT(BOARDBUT2));
-    gpio_add_callback(gpio0_dev, &but2_cb_data);
-
-    gpio_init_callback(&but3_cb_data, but3press_cbfunction, BIT(BOARDBUT3));
-    gpio_add_callback(gpio0_dev, &but3_cb_data);
-
-    gpio_init_callback(&but4_cb_data, but4press_cbfunction, BIT(BOARDBUT4));
-    gpio_add_callback(gpio0_dev, &but4_cb_data);
 }
 
 void MENU()
@@ -218,7 +218,8 @@ void thread_D_code(void *argA , void *argB, void *argC);
 void clock();
 
 /**
- * @brief Function for the configuration of all the buttons.	
+ * @brief Function for the configuration of all the buttons.
+ * \n The pins come from the sw0..sw3 aliases of the board devicetree and use the shared buttons module.
  */
 void CONFIG_BUTTONS();
 
@@ -262,25 +263,14 @@ void CHECK_DATE();
 
 
 /**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 1 was pressed.
- */ 
-void but1press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 2 was pressed.
- */ 
-void but2press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 3 was pressed.
- */ 
-void but3press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
-/**
- * @brief This function only serves to update the respective flag
- * and to inform that the button 4 was pressed.
+ * @brief Called by the shared buttons module, in interrupt context, for each debounced action of a button.
+ * \n On a press it only updates the flag of the button; the other actions are ignored.
+ * 
+ * @param event index of the button (0 to 3)
+ * @param action what happened to the button
+ * @param edge time of the GPIO edge (not used here)
  */ 
-void but4press_cbfunction(const struct device *dev, struct gpio_callback *cb, uint32_t pins);
+void buttonPressed(uint8_t event, enum button_action action, timing_t edge);
 
 
 
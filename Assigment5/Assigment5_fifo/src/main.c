@@ -161,6 +161,12 @@ struct data_item_t {
     uint16_t data;          /* Actual data */
 };
 
+/* Message pool: the producer allocates a message, the FIFO hands it over and the consumer frees it,
+ * so a message is never written while it is still in a FIFO */
+#define MSG_POOL_SIZE 8
+
+K_MEM_SLAB_DEFINE(msg_slab, sizeof(struct data_item_t), MSG_POOL_SIZE, 4);
+
 /*############*/
 
 /* ########################################################################################################################################## */
@@ -229,7 +235,7 @@ void thread_A_code(void *argA , void *argB, void *argC)
   int ret = 0;
 
   /*Fifo variable*/
-  struct data_item_t data_ab;
+  struct data_item_t *data_ab;
 
   printk("Thread A Init\n\r");
 
@@ -250,15 +256,20 @@ void thread_A_code(void *argA , void *argB, void *argC)
       {
         printk("adc reading out of range\n\r");
       } 
+      else if (k_mem_slab_alloc(&msg_slab, (void **)&data_ab, K_NO_WAIT) != 0) 
+      {
+        /* Every message is waiting in the FIFOs: the consumers are behind, the sample is dropped */
+        printk("Error %d: no free message, sample dropped\n\r", -ENOMEM);
+      } 
       else 
       {
-        data_ab.data= adc_sample_buffer[0];
-        printk("adc reading  raw: %4u / %4u mV: \n\r", data_ab.data, (uint16_t)(1000 * data_ab.data * ((float)3 / 1023)));
+        data_ab->data= adc_sample_buffer[0];
+        printk("adc reading  raw: %4u / %4u mV: \n\r", data_ab->data, (uint16_t)(1000 * data_ab->data * ((float)3 / 1023)));
+
+        k_fifo_put(&fifo_ab, data_ab); /* Thread B owns the message now */
       }
     }
 
-    k_fifo_put(&fifo_ab, &data_ab);
-
     fin_time = k_uptime_get();
 
     if (fin_time < release_time) 
@@ -279,7 +290,8 @@ void thread_B_code(void *argA , void *argB, void *argC)
   int i;
 
   struct data_item_t *data_ab;
-  struct data_item_t data_bc;
+  struct data_item_t *data_bc;
+  uint16_t sample;
 
   printk("Thread B Init\n\r");
 
@@ -290,6 +302,9 @@ void thread_B_code(void *argA , void *argB, void *argC)
    //k_sem_take(&sem_ab, K_FOREVER);
    printk("Thread B Activated\n\r");
 
+   sample = data_ab->data;
+   k_mem_slab_free(&msg_slab, (void **)&data_ab);
+
    media = 0;
    media_2 = 0;
    count = 0;
@@ -299,7 +314,7 @@ void thread_B_code(void *argA , void *argB, void *argC)
      buffer[i] = buffer[i + 1];
      /*printk("adc reading %d: raw:%4u / %4u mV: \n\r", i, buffer[i], (uint16_t)(1000 * buffer[i] * ((float)3 / 1023))); */
    }
-     buffer[WINDOW_SIZE - 1] = data_ab->data;
+     buffer[WINDOW_SIZE - 1] = sample;
      /*printk("adc reading %d: raw:%4u / %4u mV: \n\r", 9, buffer[9], (uint16_t)(1000 * buffer[9] * ((float)3 / 1023)));*/
 
    for (i = 0; i < WINDOW_SIZE; i++) 
@@ -317,19 +332,25 @@ void thread_B_code(void *argA , void *argB, void *argC)
        count = count + 1;
      }
    }
+   if (k_mem_slab_alloc(&msg_slab, (void **)&data_bc, K_NO_WAIT) != 0) 
+   {
+     printk("Error %d: no free message, result dropped\n\r", -ENOMEM);
+     continue;
+   }
+
    if (count != 0) 
    {
-     data_bc.data= media_2 / count;
+     data_bc->data= media_2 / count;
    } 
    else 
    {
-     data_bc.data= 0;
+     data_bc->data= 0;
    }
 
-   printk("adc reading %d: raw:%4u / %4u mV: \n\r", count, data_bc.data, (uint16_t)(1000 * data_bc.data * ((float)3 / 1023)));
+   printk("adc reading %d: raw:%4u / %4u mV: \n\r", count, data_bc->data, (uint16_t)(1000 * data_bc->data * ((float)3 / 1023)));
     
    //data_bc.data=var_bc;
-   k_fifo_put(&fifo_bc, &data_bc);
+   k_fifo_put(&fifo_bc, data_bc); /* Thread C owns the message now */
    
   }
 }
@@ -395,6 +416,8 @@ void thread_C_code(void *argA , void *argB, void *argC)
 
     data_bc->data = (uint16_t)(1000 * data_bc->data * ((float)3 / 1023));
     printk("PWM -> %4u \n\r",(unsigned int)((pwmPeriod_us * data_bc->data) / 3000));
+
+    k_mem_slab_free(&msg_slab, (void **)&data_bc);
   }
 }
 /* ########################################################################################################################################## */
@@ -48,11 +48,14 @@ void main(void);
  * @brief 
  * 
  * The thread A has the porpouse of reading the adc sampling and implement it the first created fifo.
+ * \n Each sample goes in a message allocated from the msg_slab pool. Thread A gives the message to the fifo and
+ * the thread that takes it out frees it, so a message in a fifo is never reused. If the pool is empty (the other
+ * threads are behind) the sample is dropped.
  * \n Then it deals with the timing to read such samples.
  *  
  * @code
  * 
- *  k_fifo_put(&fifo_ab, &data_ab);
+ *  k_fifo_put(&fifo_ab, data_ab);
  *
  *   fin_time = k_uptime_get();
  *
@@ -72,7 +75,7 @@ void thread_A_code(void *argA , void *argB, void *argC);
 /**
  * @brief 
  *  This thread deals with the information from the fifo and calculates the mean with samples that doesn't have too much deviation from the overall values.
- *  \n The resulting value is given to the next fifo for the next thread.
+ *  \n It frees the message of thread A and the resulting value is given, in a new message, to the next fifo for the next thread.
  * 
  * \n Main code for the mean:
  * @code
@@ -86,7 +89,7 @@ void thread_A_code(void *argA , void *argB, void *argC);
  *  }
  *  if (count != 0) 
  *  {
- *    data_bc.data= media_2 / count;
+ *    data_bc->data= media_2 / count;
  *  }
  *  
  * @endcode
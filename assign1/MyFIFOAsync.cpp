@@ -0,0 +1,109 @@
+/** @file MyFIFOAsync.cpp
+ * @brief Pipeline demo for the coroutine version of MyFIFO.
+ *
+ * Creates a chain of stages connected by MyFIFOAsync queues. Every stage
+ * adds 1 to the value it receives and passes it to the next one.
+ * \n The stages are spread over a few Executors, each one on its own thread,
+ * so a thousand stages only need a handful of threads.
+ *
+ * Build and run (default: 1000 stages, 4 threads, 10000 values):
+ * @verbatim
+   g++ -std=c++20 -O2 -pthread MyFIFOAsync.cpp -o MyFIFOAsync
+   ./MyFIFOAsync [stages] [threads] [values]
+   @endverbatim
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+/* Includes */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "MyFIFOAsync.h"
+
+#define FIFO_SIZE 10
+#define END_OF_STREAM -1
+
+typedef MyFIFOAsync<long, FIFO_SIZE> Queue;
+
+Task source(Queue &out, long values)
+{
+    for (long i = 0; i < values; i++) {
+        co_await out.push(i);
+    }
+    co_await out.push(END_OF_STREAM);
+}
+
+Task stage(Queue &in, Queue &out)
+{
+    while (true) {
+        long v = co_await in.pop();
+        if (v == END_OF_STREAM) {
+            co_await out.push(END_OF_STREAM);
+            break;
+        }
+        co_await out.push(v + 1);
+    }
+}
+
+Task sink(Queue &in, long &received, long &checksum)
+{
+    while (true) {
+        long v = co_await in.pop();
+        if (v == END_OF_STREAM) break;
+        received++;
+        checksum += v;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int stages = (argc > 1) ? atoi(argv[1]) : 1000;
+    int threads = (argc > 2) ? atoi(argv[2]) : 4;
+    long values = (argc > 3) ? atol(argv[3]) : 10000;
+
+    if (stages < 1 || threads < 1 || values < 0) {
+        printf("Usage: %s [stages] [threads] [values]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (int i = 0; i <= stages; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    std::vector<Executor> executors(threads);
+
+    long received = 0;
+    long checksum = 0;
+
+    executors[0].spawn(source(*queues[0], values));
+    for (int i = 0; i < stages; i++) {
+        executors[i % threads].spawn(stage(*queues[i], *queues[i + 1]));
+    }
+    executors[stages % threads].spawn(sink(*queues[stages], received, checksum));
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+        pool.emplace_back([&executors, t] { executors[t].run(); });
+    }
+    for (auto &th : pool) {
+        th.join();
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    /* Every value went through all the stages: sum(i + stages) */
+    long expected = values * (values - 1) / 2 + values * (long)stages;
+
+    printf("Stages: %d  Threads: %d  Values: %ld\n", stages, threads, values);
+    printf("Received: %ld  Checksum: %s\n", received, (checksum == expected) ? "OK" : "WRONG");
+    printf("Time: %.3f s  ->  %.0f hops/s\n", secs, (secs > 0) ? (double)values * stages / secs : 0.0);
+
+    return (received == values && checksum == expected) ? 0 : 1;
+}
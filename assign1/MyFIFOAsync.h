@@ -0,0 +1,282 @@
+/** @file MyFIFOAsync.h
+ * @brief Generic FIFO with C++20 coroutine awaitables and a small executor.
+ *
+ * This file is the host-side, generic version of the MyFIFO queue.
+ * \n Instead of blocking a thread when the FIFO is empty (pop) or full (push),
+ * the calling coroutine is suspended and later resumed on the Executor it was
+ * running on. This way many pipeline stages can share a few threads.
+ *
+ * Example of a stage:
+ * @code
+ * Task stage(MyFIFOAsync<int, 10> &in, MyFIFOAsync<int, 10> &out)
+ * {
+ *     while (true) {
+ *         int v = co_await in.pop();
+ *         co_await out.push(v + 1);
+ *     }
+ * }
+ * @endcode
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _MyFIFOAsync_h
+#define _MyFIFOAsync_h
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <utility>
+
+class Executor;
+
+/**
+ * @brief Detached coroutine used for the pipeline stages.
+ * The coroutine starts suspended and only runs after Executor::spawn().
+ * \n When it finishes the frame is destroyed and the Executor is informed.
+ */
+struct Task
+{
+    struct promise_type
+    {
+        Executor *home = nullptr; /**< Executor that owns the coroutine */
+
+        Task get_return_object()
+        {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept;
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle; /**< Handle of the coroutine frame */
+};
+
+/**
+ * @brief Lightweight single-threaded executor.
+ * It keeps a queue of ready coroutines and resumes them one by one on the
+ * thread that called run(). Other threads may post() into it.
+ * \n run() returns once every coroutine spawned on it has finished.
+ */
+class Executor
+{
+public:
+    /**
+     * @brief Gives a coroutine to this executor and makes it ready to run.
+     * @param task coroutine created by calling a Task function
+     */
+    void spawn(Task task)
+    {
+        task.handle.promise().home = this;
+        live.fetch_add(1, std::memory_order_relaxed);
+        post(task.handle);
+    }
+
+    /**
+     * @brief Puts a suspended coroutine in the ready queue.
+     * Can be called from any thread.
+     */
+    void post(std::coroutine_handle<> h)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(h);
+        }
+        cv.notify_one();
+    }
+
+    /**
+     * @brief Resumes ready coroutines until all the spawned ones are done.
+     */
+    void run()
+    {
+        current_executor() = this;
+        while (live.load(std::memory_order_acquire) != 0) {
+            std::coroutine_handle<> h;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this] { return !ready.empty(); });
+                h = ready.front();
+                ready.pop_front();
+            }
+            h.resume();
+        }
+        current_executor() = nullptr;
+    }
+
+    /**
+     * @brief Executor running on the calling thread (nullptr if none).
+     */
+    static Executor *current()
+    {
+        return current_executor();
+    }
+
+    /**
+     * @brief Called when a coroutine of this executor finishes.
+     */
+    void task_done()
+    {
+        live.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    static Executor *&current_executor()
+    {
+        thread_local Executor *exec = nullptr;
+        return exec;
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::coroutine_handle<>> ready;
+    std::atomic<int> live{0};
+};
+
+inline auto Task::promise_type::final_suspend() noexcept
+{
+    struct Finish
+    {
+        bool await_ready() noexcept { return false; }
+        void await_suspend(std::coroutine_handle<promise_type> h) noexcept
+        {
+            Executor *exec = h.promise().home;
+            h.destroy();
+            exec->task_done();
+        }
+        void await_resume() noexcept {}
+    };
+    return Finish{};
+}
+
+/**
+ * @brief Generic circular FIFO with awaitable push and pop.
+ *
+ * Waiting coroutines are kept in the order they arrived. When a value is
+ * pushed and a consumer is waiting, the value is handed directly to it; when
+ * a value is popped and a producer is waiting, its value takes the free slot.
+ * \n The waiters are resumed on the executor they were running on.
+ *
+ * @tparam T type of the elements
+ * @tparam N capacity of the FIFO
+ */
+template <typename T, std::size_t N>
+class MyFIFOAsync
+{
+    static_assert(N > 0, "MyFIFOAsync needs at least one slot");
+
+    struct Waiter
+    {
+        std::coroutine_handle<> handle;
+        Executor *exec;
+        T *value; /**< Value to give (push) or place to store it (pop) */
+    };
+
+public:
+    /** @brief Awaitable returned by pop(). Gives the oldest element. */
+    class PopAwaiter
+    {
+    public:
+        explicit PopAwaiter(MyFIFOAsync &f) : fifo(f) {}
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            std::lock_guard<std::mutex> lock(fifo.mutex);
+            if (fifo.count > 0) {
+                value = fifo.take();
+                return false;
+            }
+            fifo.poppers.push_back(Waiter{h, Executor::current(), &value});
+            return true;
+        }
+        T await_resume() { return std::move(value); }
+
+    private:
+        MyFIFOAsync &fifo;
+        T value{};
+    };
+
+    /** @brief Awaitable returned by push(). Inserts one element. */
+    class PushAwaiter
+    {
+    public:
+        PushAwaiter(MyFIFOAsync &f, T v) : fifo(f), value(std::move(v)) {}
+        bool await_ready() noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h)
+        {
+            std::lock_guard<std::mutex> lock(fifo.mutex);
+            if (!fifo.poppers.empty()) {
+                Waiter w = fifo.poppers.front();
+                fifo.poppers.pop_front();
+                *w.value = std::move(value);
+                w.exec->post(w.handle);
+                return false;
+            }
+            if (fifo.count < N) {
+                fifo.put(std::move(value));
+                return false;
+            }
+            fifo.pushers.push_back(Waiter{h, Executor::current(), &value});
+            return true;
+        }
+        void await_resume() noexcept {}
+
+    private:
+        MyFIFOAsync &fifo;
+        T value;
+    };
+
+    /** @brief Waits until there is an element and removes it. */
+    PopAwaiter pop() { return PopAwaiter(*this); }
+
+    /** @brief Waits until there is space and inserts the element. */
+    PushAwaiter push(T v) { return PushAwaiter(*this, std::move(v)); }
+
+    /** @brief Number of elements in the FIFO. */
+    std::size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+
+private:
+    /* Both helpers are called with the mutex locked */
+    void put(T v)
+    {
+        buf[write_pointer] = std::move(v);
+        write_pointer = (write_pointer + 1) % N;
+        count++;
+    }
+
+    T take()
+    {
+        T v = std::move(buf[read_pointer]);
+        read_pointer = (read_pointer + 1) % N;
+        count--;
+        if (!pushers.empty()) {
+            Waiter w = pushers.front();
+            pushers.pop_front();
+            put(std::move(*w.value));
+            w.exec->post(w.handle);
+        }
+        return v;
+    }
+
+    std::mutex mutex;
+    std::array<T, N> buf{};
+    std::size_t write_pointer = 0;
+    std::size_t read_pointer = 0;
+    std::size_t count = 0;
+    std::deque<Waiter> poppers;
+    std::deque<Waiter> pushers;
+};
+
+#endif
@@ -0,0 +1,264 @@
+/** @file buttons.c
+ * @brief Shared button input module.
+ *
+ * Each GPIO port with buttons has one gpio_callback, armed on both edges.
+ * The callback does not read the pins: it stamps the edge of the buttons
+ * that changed and starts the scan timer when it is stopped. The timer
+ * reads every port once per period and runs an integrator for each button
+ * (BUTTONS_DEBOUNCE_MS to change state), so the bounces of a contact never
+ * reach the application.
+ * \n While a button is held, the same timer counts the hold time and gives
+ * the long press and the repeats. With every button released and stable the
+ * timer stops and the buttons cost nothing until the next edge.
+ * \n The callback walks only the pins that changed, with a per port pin to
+ * button table, and stamps the first edge of each button. The stamp is kept
+ * until it is reported with the press or release, or until the button has
+ * been stable for BUTTONS_DEBOUNCE_MS (a glitch).
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#include <zephyr.h>
+#include <device.h>
+#include <drivers/gpio.h>
+#include <sys/printk.h>
+#include <sys/math_extras.h>
+#include <string.h>
+
+#include "buttons.h"
+
+#define PINS_PER_PORT 32
+#define NO_BUTTON 0xff /* Pin without a button */
+
+#define DEBOUNCE_SCANS (BUTTONS_DEBOUNCE_MS / BUTTONS_SCAN_MS)
+#define LONG_PRESS_SCANS (BUTTONS_LONG_PRESS_MS / BUTTONS_SCAN_MS)
+#define REPEAT_SCANS (BUTTONS_REPEAT_MS / BUTTONS_SCAN_MS)
+
+struct button_port {
+    const struct device *port;
+    struct gpio_callback cb;
+    gpio_port_pins_t mask;
+    uint8_t button_of_pin[PINS_PER_PORT]; /* Index in state[] of the button on each pin */
+};
+
+struct button_state {
+    uint8_t port;       /* Index in ports[] */
+    uint8_t integrator; /* 0 = released, DEBOUNCE_SCANS = pressed */
+    bool pressed;       /* Debounced state */
+    uint16_t held;      /* Scans since the press */
+    uint8_t quiet;      /* Scans stable since the last edge stamp */
+    volatile bool edge_pending; /* edge holds the first edge not reported yet */
+    timing_t edge;
+};
+
+static struct button_port ports[BUTTONS_MAX_PORTS];
+static size_t num_ports = 0;
+
+static const struct button_map *buttons;
+static struct button_state state[BUTTONS_MAX];
+static size_t num_buttons = 0;
+static button_handler_t button_handler = NULL;
+
+static volatile bool scanning = false;
+static volatile bool edge_seen = false;
+
+static void scan_timer_handler(struct k_timer *timer);
+K_TIMER_DEFINE(scan_timer, scan_timer_handler, NULL);
+
+/* Any edge on any button: stamp it and make sure the scan is running.
+ * Only the pins that changed are visited, so the work does not grow with the number of buttons */
+static void buttons_isr(const struct device *dev, struct gpio_callback *cb, gpio_port_pins_t pins)
+{
+    struct button_port *bp = CONTAINER_OF(cb, struct button_port, cb);
+    timing_t now = buttons_now();
+    struct button_state *b;
+    uint8_t i;
+
+    pins &= bp->mask;
+    while (pins != 0) {
+        i = bp->button_of_pin[u32_count_trailing_zeros(pins)];
+        pins &= pins - 1; /* Clears the lowest pin */
+
+        if (i == NO_BUTTON) {
+            continue;
+        }
+        b = &state[i];
+        if (!b->edge_pending) {
+            b->edge = now;
+            b->edge_pending = true;
+            b->quiet = 0;
+        }
+    }
+
+    edge_seen = true;
+    if (!scanning) {
+        scanning = true;
+        k_timer_start(&scan_timer, K_MSEC(BUTTONS_SCAN_MS), K_MSEC(BUTTONS_SCAN_MS));
+    }
+}
+
+/* Stamp of the press or release being reported: its first edge, or now if none was seen */
+static timing_t take_edge(struct button_state *b, timing_t now)
+{
+    timing_t edge = b->edge_pending ? b->edge : now;
+
+    b->edge_pending = false;
+    b->quiet = 0;
+    return edge;
+}
+
+/* Runs every BUTTONS_SCAN_MS while a button is active or bouncing */
+static void scan_timer_handler(struct k_timer *timer)
+{
+    gpio_port_value_t level[BUTTONS_MAX_PORTS];
+    struct button_state *b;
+    bool idle = true;
+    bool active;
+    timing_t now = buttons_now();
+    unsigned int key;
+    size_t i;
+
+    edge_seen = false;
+    for (i = 0; i < num_ports; i++) {
+        if (gpio_port_get(ports[i].port, &level[i]) != 0) {
+            level[i] = 0;
+        }
+    }
+
+    for (i = 0; i < num_buttons; i++) {
+        b = &state[i];
+        active = (level[b->port] & BIT(buttons[i].spec.pin)) != 0;
+
+        if (active && b->integrator < DEBOUNCE_SCANS) {
+            b->integrator++;
+        } else if (!active && b->integrator > 0) {
+            b->integrator--;
+        }
+
+        if (!b->pressed && b->integrator == DEBOUNCE_SCANS) {
+            b->pressed = true;
+            b->held = 0;
+            button_handler(buttons[i].event, BUTTON_PRESS, take_edge(b, now));
+        } else if (b->pressed && b->integrator == 0) {
+            b->pressed = false;
+            button_handler(buttons[i].event, BUTTON_RELEASE, take_edge(b, now));
+        } else if (b->pressed) {
+            b->held++;
+            if (b->held == LONG_PRESS_SCANS) {
+                button_handler(buttons[i].event, BUTTON_LONG_PRESS, now);
+            } else if (b->held == LONG_PRESS_SCANS + REPEAT_SCANS) {
+                b->held = LONG_PRESS_SCANS;
+                button_handler(buttons[i].event, BUTTON_REPEAT, now);
+            }
+        }
+
+        /* Back to its debounced level for a whole debounce time: the edge was a glitch */
+        if (b->integrator == (b->pressed ? DEBOUNCE_SCANS : 0)) {
+            if (b->quiet < DEBOUNCE_SCANS) {
+                b->quiet++;
+            } else {
+                b->edge_pending = false;
+            }
+        } else {
+            b->quiet = 0;
+        }
+
+        if (b->pressed || b->integrator != 0) {
+            idle = false;
+        }
+    }
+
+    /* An edge after the ports were read keeps the scan going */
+    key = irq_lock();
+    if (idle && !edge_seen) {
+        k_timer_stop(&scan_timer);
+        scanning = false;
+    }
+    irq_unlock(key);
+}
+
+/* Returns the index of the port, adding it if needed (-1 if there is no space) */
+static int get_port(const struct device *port)
+{
+    size_t i;
+
+    for (i = 0; i < num_ports; i++) {
+        if (ports[i].port == port) {
+            return (int)i;
+        }
+    }
+    if (num_ports == BUTTONS_MAX_PORTS) {
+        return -1;
+    }
+
+    ports[num_ports].port = port;
+    ports[num_ports].mask = 0;
+    memset(ports[num_ports].button_of_pin, NO_BUTTON, PINS_PER_PORT);
+    return (int)num_ports++;
+}
+
+int buttons_init(const struct button_map *map, size_t count, button_handler_t handler)
+{
+    int port;
+    size_t i;
+    int ret;
+
+    if (count > BUTTONS_MAX) {
+        printk("Error: more than %d buttons\n\r", BUTTONS_MAX);
+        return -ENOMEM;
+    }
+
+    buttons = map;
+    num_buttons = count;
+    button_handler = handler;
+
+#ifdef CONFIG_TIMING_FUNCTIONS
+    timing_init();
+    timing_start();
+#endif
+
+    for (i = 0; i < count; i++) {
+        if (!device_is_ready(map[i].spec.port)) {
+            printk("Error: GPIO port of button %d not ready\n\r", (int)i + 1);
+            return -ENODEV;
+        }
+
+        ret = gpio_pin_configure_dt(&map[i].spec, GPIO_INPUT);
+        if (ret < 0) {
+            printk("Error %d: Failed to configure button %d \n\r", ret, (int)i + 1);
+            return ret;
+        }
+
+        ret = gpio_pin_interrupt_configure_dt(&map[i].spec, GPIO_INT_EDGE_BOTH);
+        if (ret != 0) {
+            printk("Error %d: failed to configure interrupt on button %d \n\r", ret, (int)i + 1);
+            return ret;
+        }
+
+        port = get_port(map[i].spec.port);
+        if (port < 0) {
+            printk("Error: buttons use more than %d GPIO ports\n\r", BUTTONS_MAX_PORTS);
+            return -ENOMEM;
+        }
+        ports[port].mask |= BIT(map[i].spec.pin);
+        ports[port].button_of_pin[map[i].spec.pin] = (uint8_t)i;
+        state[i].port = (uint8_t)port;
+        state[i].integrator = 0;
+        state[i].pressed = false;
+        state[i].held = 0;
+        state[i].quiet = 0;
+        state[i].edge_pending = false;
+    }
+
+    for (i = 0; i < num_ports; i++) {
+        gpio_init_callback(&ports[i].cb, buttons_isr, ports[i].mask);
+        ret = gpio_add_callback(ports[i].port, &ports[i].cb);
+        if (ret != 0) {
+            printk("Error %d: failed to add the buttons callback\n\r", ret);
+            return ret;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/** @file buttons.h
+ * @brief Shared button input module.
+ *
+ * The buttons are described by a table that maps each gpio_dt_spec to an
+ * event code. The module registers one gpio_callback per GPIO port.
+ * \n The buttons are debounced by sampling all of them together with one
+ * shared k_timer every BUTTONS_SCAN_MS. The GPIO interrupt only starts that
+ * timer when it is stopped, and the timer stops again once every button is
+ * released and stable, so there is no work per edge in interrupt context
+ * and no periodic wakeup while nobody touches the machine.
+ * \n For each button the module reports the press, the release, the long
+ * press (held for BUTTONS_LONG_PRESS_MS) and, after the long press, one
+ * repeat every BUTTONS_REPEAT_MS.
+ * \n The GPIO interrupt also stamps the first edge of each button with
+ * buttons_now(), and the press or release it ends in is reported with that
+ * stamp, so the latency measured by the application starts at the edge and
+ * not BUTTONS_DEBOUNCE_MS later.
+ *
+ * Usage:
+ * @code
+ * static const struct button_map map[] = {
+ *     { GPIO_DT_SPEC_GET(DT_ALIAS(sw0), gpios), EVT_BUT1 },
+ *     { GPIO_DT_SPEC_GET(DT_ALIAS(sw1), gpios), EVT_BUT2 },
+ * };
+ *
+ * buttons_init(map, ARRAY_SIZE(map), buttonPressed);
+ * @endcode
+ *
+ * @author José Mestre Batista and Renato Rocha
+ * @date 19 October 2026
+ */
+
+#ifndef _buttons_h
+#define _buttons_h
+
+#include <zephyr.h>
+#include <drivers/gpio.h>
+#include <timing/timing.h>
+
+#define BUTTONS_MAX_PORTS 2     /* GPIO ports that can have buttons */
+#define BUTTONS_MAX 16          /* Buttons that can be registered */
+
+#define BUTTONS_SCAN_MS 5           /* Period of the debounce sampling */
+#define BUTTONS_DEBOUNCE_MS 20      /* Time a new level must be stable */
+#define BUTTONS_LONG_PRESS_MS 1000  /* Hold time for a long press */
+#define BUTTONS_REPEAT_MS 200       /* Period of the repeats after a long press */
+
+/**
+ * @brief What happened to the button.
+ */
+enum button_action {
+    BUTTON_PRESS,      /**< Pressed (after debounce) */
+    BUTTON_RELEASE,    /**< Released (after debounce) */
+    BUTTON_LONG_PRESS, /**< Held for BUTTONS_LONG_PRESS_MS */
+    BUTTON_REPEAT      /**< Still held, once every BUTTONS_REPEAT_MS after the long press */
+};
+
+/**
+ * @brief One button: the pin (from the devicetree) and the event it generates.
+ */
+struct button_map {
+    struct gpio_dt_spec spec; /**< Pin of the button, with its devicetree flags */
+    uint8_t event;            /**< Event code given to the handler */
+};
+
+/**
+ * @brief Function called, in interrupt context (timer expiry), for each debounced
+ * action of a button.
+ * @param event event code of the button
+ * @param action what happened to the button
+ * @param edge buttons_now() at the first edge of a press or release; for a long
+ * press or a repeat, at the scan that reports it
+ */
+typedef void (*button_handler_t)(uint8_t event, enum button_action action, timing_t edge);
+
+/**
+ * @brief Clock of the edge stamps: the timing counter (cycles, started by
+ * buttons_init()) when CONFIG_TIMING_FUNCTIONS is set, else k_cycle_get_32().
+ * @return current time, in cycles of that clock
+ */
+static inline timing_t buttons_now(void)
+{
+#ifdef CONFIG_TIMING_FUNCTIONS
+    return timing_counter_get();
+#else
+    return k_cycle_get_32();
+#endif
+}
+
+/**
+ * @brief Configures the buttons as inputs with interrupt on both edges
+ * and registers one callback for each GPIO port used.
+ *
+ * @param map table with the buttons (must stay valid, it is not copied)
+ * @param count number of buttons in the table
+ * @param handler function called for each action of a button
+ * @return 0 on success, or a negative error code
+ */
+int buttons_init(const struct button_map *map, size_t count, button_handler_t handler);
+
+#endif
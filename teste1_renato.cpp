@@ -1,29 +1,178 @@
-//
-// Created by renat on 15/03/2022.
-//
-
-#include "teste1_renato.h"
-
-int main(void)
-{
-    while (1)
-    {
-        for(int n=0;n<10;n++)
-        {
-            for(int m = 0;m<10;m++)
-            {
-                int o = add_numbers(n,m);
-                printf("O numero somado é : %d \n",&o);
-            }
-        }
-
-    }
-
-}
-
-int add_numbers(x,y)
-{
-   int z = x+y;
-   return z;
-   // bye
-}
\ No newline at end of file
+//
+// Created by renat on 15/03/2022.
+//
+
+#include "teste1_renato.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#define TABLE_BUFFER_SIZE 65536
+#define TABLE_LINE_MAX 64
+
+static const char table_text[] = "O numero somado é : ";
+
+int add_numbers(int x, int y)
+{
+   int z = x+y;
+   return z;
+   // bye
+}
+
+void add_numbers_batch(const int *a, const int *b, int *out, std::size_t n)
+{
+    std::size_t i = 0;
+
+#if defined(__SSE2__)
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+        _mm_storeu_si128((__m128i *)(out + i), _mm_add_epi32(va, vb));
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 4 <= n; i += 4)
+    {
+        vst1q_s32(out + i, vaddq_s32(vld1q_s32(a + i), vld1q_s32(b + i)));
+    }
+#endif
+
+    // Remaining elements (or everything, without SIMD)
+    for (; i < n; i++)
+    {
+        out[i] = add_numbers(a[i], b[i]);
+    }
+}
+
+// Writes the decimal value of v at p, returns the number of chars written
+static int format_int(char *p, int v)
+{
+    char tmp[12];
+    int len = 0;
+    unsigned int u = (v < 0) ? 0u - (unsigned int)v : (unsigned int)v;
+
+    do
+    {
+        tmp[len++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+
+    int pos = 0;
+    if (v < 0) p[pos++] = '-';
+    while (len > 0) p[pos++] = tmp[--len];
+    return pos;
+}
+
+int write_sum_table(FILE *stream, int rows, int cols)
+{
+    if (rows <= 0 || cols <= 0) return 0;
+
+    static char out_buf[TABLE_BUFFER_SIZE];
+    std::size_t used = 0;
+    const std::size_t text_len = sizeof(table_text) - 1;
+
+    std::vector<int> row(cols), col(cols), sums(cols);
+    for (int m = 0; m < cols; m++) col[m] = m;
+
+    for (int n = 0; n < rows; n++)
+    {
+        for (int m = 0; m < cols; m++) row[m] = n;
+        add_numbers_batch(row.data(), col.data(), sums.data(), cols);
+
+        for (int m = 0; m < cols; m++)
+        {
+            if (used + TABLE_LINE_MAX > sizeof(out_buf))
+            {
+                if (fwrite(out_buf, 1, used, stream) != used) return -1;
+                used = 0;
+            }
+            memcpy(out_buf + used, table_text, text_len);
+            used += text_len;
+            used += format_int(out_buf + used, sums[m]);
+            out_buf[used++] = ' ';
+            out_buf[used++] = '\n';
+        }
+    }
+
+    if (used > 0 && fwrite(out_buf, 1, used, stream) != used) return -1;
+    return ferror(stream) ? -1 : 0;
+}
+
+// Compares the old one-pair-at-a-time code with the batch versions
+static void benchmark(std::size_t n)
+{
+    typedef std::chrono::steady_clock clk;
+    const int reps = 100;
+
+    std::vector<int> a(n), b(n), out(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        a[i] = (int)i;
+        b[i] = (int)(n - i);
+    }
+
+    auto t0 = clk::now();
+    for (int r = 0; r < reps; r++)
+        for (std::size_t i = 0; i < n; i++) out[i] = add_numbers(a[i], b[i]);
+    auto t1 = clk::now();
+    for (int r = 0; r < reps; r++) add_numbers_batch(a.data(), b.data(), out.data(), n);
+    auto t2 = clk::now();
+
+    double pair_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / (reps * (double)n);
+    double batch_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / (reps * (double)n);
+    printf("add_numbers       : %.3f ns/element\n", pair_ns);
+    printf("add_numbers_batch : %.3f ns/element\n", batch_ns);
+
+    // Table of 1000 x 1000 lines, printf per value vs buffered writer
+    const int side = 1000;
+    FILE *sink = tmpfile();
+    if (sink == NULL)
+    {
+        printf("Could not open a temporary file for the table benchmark\n");
+        return;
+    }
+
+    auto t3 = clk::now();
+    for (int i = 0; i < side; i++)
+        for (int j = 0; j < side; j++) fprintf(sink, "%s%d \n", table_text, add_numbers(i, j));
+    fflush(sink);
+    auto t4 = clk::now();
+    rewind(sink);
+    write_sum_table(sink, side, side);
+    fflush(sink);
+    auto t5 = clk::now();
+    fclose(sink);
+
+    printf("table with printf : %.1f ms\n", std::chrono::duration<double, std::milli>(t4 - t3).count());
+    printf("write_sum_table   : %.1f ms\n", std::chrono::duration<double, std::milli>(t5 - t4).count());
+}
+
+// Usage: teste1_renato [rows [cols]] -> prints the addition table (default 10 x 10)
+//        teste1_renato bench [n]     -> runs the benchmark with arrays of n elements (n > 0)
+int main(int argc, char **argv)
+{
+    if (argc > 1 && strcmp(argv[1], "bench") == 0)
+    {
+        std::size_t n = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000000;
+        if (n == 0)
+        {
+            printf("The benchmark needs at least 1 element\n");
+            return 1;
+        }
+        benchmark(n);
+        return 0;
+    }
+
+    int rows = (argc > 1) ? atoi(argv[1]) : 10;
+    int cols = (argc > 2) ? atoi(argv[2]) : 10;
+
+    return (write_sum_table(stdout, rows, cols) == 0) ? 0 : 1;
+}
@@ -1,9 +1,25 @@
-//
-// Created by renat on 15/03/2022.
-//
-
-#ifndef SETR_TESTE1_RENATO_H
-#define SETR_TESTE1_RENATO_H
-
-#endif //SETR_TESTE1_RENATO_H
-// bye
\ No newline at end of file
+//
+// Created by renat on 15/03/2022.
+//
+
+#ifndef SETR_TESTE1_RENATO_H
+#define SETR_TESTE1_RENATO_H
+
+#include <cstddef>
+#include <cstdio>
+
+// Adds two numbers
+int add_numbers(int x, int y);
+
+// Adds whole arrays: out[i] = a[i] + b[i], for i < n.
+// Uses SSE2 / NEON when the compiler enables them, scalar code otherwise.
+// out may be the same array as a or b.
+void add_numbers_batch(const int *a, const int *b, int *out, std::size_t n);
+
+// Writes the addition table of [0, rows) x [0, cols) to the stream.
+// The lines are built in a local buffer and written with fwrite in big
+// blocks, so the table is not limited by one printf per value.
+// Returns 0 on success, -1 if the stream reports an error.
+int write_sum_table(FILE *stream, int rows, int cols);
+
+#endif //SETR_TESTE1_RENATO_H